@@ -11,15 +11,53 @@
 #include <utility>
 
 namespace mystl {
+// ********** [segmented iterator] **********
+//对分段迭代器区间[first, last)的每一段原生指针区间[p, q)依次调用op(p, q)
+template<typename SegmentedIterator, typename Op>
+void _for_each_segment(SegmentedIterator first, SegmentedIterator last, Op op)
+{
+    typedef segmented_iterator_traits<SegmentedIterator> traits;
+    typename traits::segment_iterator sfirst = traits::segment(first);
+    typename traits::segment_iterator slast = traits::segment(last);
+    if (sfirst == slast){
+        op(traits::local(first), traits::local(last));
+        return;
+    }
+    op(traits::local(first), traits::end(sfirst));
+    for (++sfirst; sfirst != slast; ++sfirst)
+        op(traits::begin(sfirst), traits::end(sfirst));
+    op(traits::begin(slast), traits::local(last));
+}
+
 // ********** [fill] **********
 // ********** [Algorithm Complexity: O(N)] **********
 template<typename ForwardIterator, typename T>
-void fill(ForwardIterator first, ForwardIterator last, const T& value)
+void fill(ForwardIterator first, ForwardIterator last, const T& value);
+
+template<typename ForwardIterator, typename T>
+void _fill(ForwardIterator first, ForwardIterator last, const T& value, _false_type)
 {
     for (; first != last; ++first)
         *first = value;
 }
 
+//逐段填充原生指针区间，char等类型使用memset
+template<typename SegmentedIterator, typename T>
+void _fill(SegmentedIterator first, SegmentedIterator last, const T& value, _true_type)
+{
+    typedef typename segmented_iterator_traits<SegmentedIterator>::local_iterator local_iterator;
+    _for_each_segment(first, last, [&value](local_iterator p, local_iterator q){
+        mystl::fill(p, q, value);
+    });
+}
+
+template<typename ForwardIterator, typename T>
+void fill(ForwardIterator first, ForwardIterator last, const T& value)
+{
+    typedef typename segmented_iterator_traits<ForwardIterator>::is_segmented_iterator is_segmented;
+    _fill(first, last, value, is_segmented());
+}
+
 inline void fill(char *first, char *last, const char& value)
 {
     memset(first, static_cast<unsigned char>(value), last - first);
@@ -201,16 +239,37 @@ bool is_heap(RandomAccessIterator first, RandomAccessIterator last, Compare comp
 // ********** [for_each] ***********
 // ********** [Algorithm Complexity: O(N)] **********
 template <typename InputIterator, typename Function>
-Function for_each(InputIterator first, InputIterator last, Function fn){
+Function for_each(InputIterator first, InputIterator last, Function fn);
+
+template <typename InputIterator, typename Function>
+Function _for_each(InputIterator first, InputIterator last, Function fn, _false_type){
     for (; first != last; ++first)
         fn(*first);
     return fn;
 }
 
+template <typename SegmentedIterator, typename Function>
+Function _for_each(SegmentedIterator first, SegmentedIterator last, Function fn, _true_type){
+    typedef typename segmented_iterator_traits<SegmentedIterator>::local_iterator local_iterator;
+    _for_each_segment(first, last, [&fn](local_iterator p, local_iterator q){
+        fn = mystl::for_each(p, q, fn);
+    });
+    return fn;
+}
+
+template <typename InputIterator, typename Function>
+Function for_each(InputIterator first, InputIterator last, Function fn){
+    typedef typename segmented_iterator_traits<InputIterator>::is_segmented_iterator is_segmented;
+    return _for_each(first, last, fn, is_segmented());
+}
+
 // ********** [find] **********
 // ********** [Algorithm Complexity: O(N)] ***********
 template <typename InputIterator, typename T>
-InputIterator find(InputIterator first, InputIterator last, const T& val){
+InputIterator find(InputIterator first, InputIterator last, const T& val);
+
+template <typename InputIterator, typename T>
+InputIterator _find(InputIterator first, InputIterator last, const T& val, _false_type){
     for (; first != last; ++first){
         if (*first == val)
             break;
@@ -218,6 +277,31 @@ InputIterator find(InputIterator first, InputIterator last, const T& val){
     return first;
 }
 
+//逐段查找，找到时由所在的段与段内指针合成迭代器
+template <typename SegmentedIterator, typename T>
+SegmentedIterator _find(SegmentedIterator first, SegmentedIterator last, const T& val, _true_type){
+    typedef segmented_iterator_traits<SegmentedIterator> traits;
+    typename traits::segment_iterator sfirst = traits::segment(first);
+    typename traits::segment_iterator slast = traits::segment(last);
+    if (sfirst == slast)
+        return traits::compose(sfirst, mystl::find(traits::local(first), traits::local(last), val));
+    typename traits::local_iterator p = mystl::find(traits::local(first), traits::end(sfirst), val);
+    if (p != traits::end(sfirst))
+        return traits::compose(sfirst, p);
+    for (++sfirst; sfirst != slast; ++sfirst){
+        p = mystl::find(traits::begin(sfirst), traits::end(sfirst), val);
+        if (p != traits::end(sfirst))
+            return traits::compose(sfirst, p);
+    }
+    return traits::compose(slast, mystl::find(traits::begin(slast), traits::local(last), val));
+}
+
+template <typename InputIterator, typename T>
+InputIterator find(InputIterator first, InputIterator last, const T& val){
+    typedef typename segmented_iterator_traits<InputIterator>::is_segmented_iterator is_segmented;
+    return _find(first, last, val, is_segmented());
+}
+
 // ********** [find_if] **********
 // ********** [Algorithm Complexity: O(N)] ***********
 template <typename InputIterator, typename UnaryPredicate>
@@ -257,6 +341,10 @@ typename iterator_traits<InputIterator>::difference_type
 
 // ********** [equal] **********
 // ********** [Algorithm Complexity: O(N)] **********
+template <typename InputIterator1, typename InputIterator2, typename BinaryPredicate>
+bool equal(InputIterator1 first1, InputIterator1 last1,
+    InputIterator2 first2, BinaryPredicate pred);
+
 template <typename InputIterator1, typename InputIterator2>
 bool equal(InputIterator1 first1, InputIterator1 last1,
     InputIterator2 first2){
@@ -264,9 +352,10 @@ bool equal(InputIterator1 first1, InputIterator1 last1,
          std::equal_to<typename mystl::iterator_traits<InputIterator1>::value_type>());
 }
 
+//比较[first1, last1)与first2起的区间，first2随之前进
 template <typename InputIterator1, typename InputIterator2, typename BinaryPredicate>
-bool equal(InputIterator1 first1, InputIterator1 last1,
-    InputIterator2 first2, BinaryPredicate pred){
+bool _equal_advance(InputIterator1 first1, InputIterator1 last1,
+    InputIterator2& first2, BinaryPredicate pred, _false_type){
     for (; first1 != last1; ++first1, ++first2){
         if (!pred(*first1, *first2))
             return false;
@@ -274,6 +363,63 @@ bool equal(InputIterator1 first1, InputIterator1 last1,
     return true;
 }
 
+template <typename InputIterator1, typename SegmentedIterator, typename BinaryPredicate>
+bool _equal_advance(InputIterator1 first1, InputIterator1 last1,
+    SegmentedIterator& first2, BinaryPredicate pred, _true_type){
+    return _equal_advance(first1, last1, first2, pred, _false_type());
+}
+
+//第一个区间是原生指针、第二个是分段迭代器时，按第二个区间的段切分，逐段比较原生指针区间
+template <typename T, typename SegmentedIterator, typename BinaryPredicate>
+bool _equal_advance(T *first1, T *last1,
+    SegmentedIterator& first2, BinaryPredicate pred, _true_type){
+    typedef segmented_iterator_traits<SegmentedIterator> traits;
+    while (first1 != last1){
+        typename traits::local_iterator p = traits::local(first2);
+        ptrdiff_t n = traits::end(traits::segment(first2)) - p;
+        if (last1 - first1 < n)
+            n = last1 - first1;
+        if (!_equal_advance(first1, first1 + n, p, pred, _false_type()))
+            return false;
+        first1 += n;
+        first2 += n;
+    }
+    return true;
+}
+
+template <typename InputIterator1, typename InputIterator2, typename BinaryPredicate>
+bool _equal(InputIterator1 first1, InputIterator1 last1,
+    InputIterator2 first2, BinaryPredicate pred, _false_type){
+    typedef typename segmented_iterator_traits<InputIterator2>::is_segmented_iterator is_segmented;
+    return _equal_advance(first1, last1, first2, pred, is_segmented());
+}
+
+//按第一个区间的段逐段比较
+template <typename SegmentedIterator, typename InputIterator2, typename BinaryPredicate>
+bool _equal(SegmentedIterator first1, SegmentedIterator last1,
+    InputIterator2 first2, BinaryPredicate pred, _true_type){
+    typedef segmented_iterator_traits<SegmentedIterator> traits;
+    typedef typename segmented_iterator_traits<InputIterator2>::is_segmented_iterator is_segmented;
+    typename traits::segment_iterator sfirst = traits::segment(first1);
+    typename traits::segment_iterator slast = traits::segment(last1);
+    if (sfirst == slast)
+        return _equal_advance(traits::local(first1), traits::local(last1), first2, pred, is_segmented());
+    if (!_equal_advance(traits::local(first1), traits::end(sfirst), first2, pred, is_segmented()))
+        return false;
+    for (++sfirst; sfirst != slast; ++sfirst){
+        if (!_equal_advance(traits::begin(sfirst), traits::end(sfirst), first2, pred, is_segmented()))
+            return false;
+    }
+    return _equal_advance(traits::begin(slast), traits::local(last1), first2, pred, is_segmented());
+}
+
+template <typename InputIterator1, typename InputIterator2, typename BinaryPredicate>
+bool equal(InputIterator1 first1, InputIterator1 last1,
+    InputIterator2 first2, BinaryPredicate pred){
+    typedef typename segmented_iterator_traits<InputIterator1>::is_segmented_iterator is_segmented;
+    return _equal(first1, last1, first2, pred, is_segmented());
+}
+
 // ********** [advance] ***********
 // ********** [Algorithm Complexity: O(N)] **********
 namespace {
@@ -406,7 +552,7 @@ typename iterator_traits<Iterator>::difference_type
 template<typename InputIterator, typename OutputIterator>
 OutputIterator __copy(InputIterator first, InputIterator last, OutputIterator result, _true_type){
     auto dist = distance(first, last);
-    memcpy(result, first, sizeof(*first) * dist);
+    memmove(result, first, sizeof(*first) * dist);
     advance(result, dist);
     return result;
 }
@@ -428,21 +574,71 @@ OutputIterator _copy(InputIterator first, InputIterator last, OutputIterator res
 }
 
 template <typename InputIterator, typename OutputIterator>
-OutputIterator copy(InputIterator first, InputIterator last, OutputIterator result){
+OutputIterator copy(InputIterator first, InputIterator last, OutputIterator result);
+
+//输出是分段迭代器时，一般的输入逐个复制
+template <typename InputIterator, typename SegmentedIterator>
+SegmentedIterator _copy_to_segments(InputIterator first, InputIterator last, SegmentedIterator result){
+    return __copy(first, last, result, _false_type());
+}
+
+//输入是原生指针时，按输出的段切分，每段以原生指针复制，POD类型使用memmove
+template <typename T, typename SegmentedIterator>
+SegmentedIterator _copy_to_segments(T *first, T *last, SegmentedIterator result){
+    typedef segmented_iterator_traits<SegmentedIterator> traits;
+    while (first != last){
+        typename traits::local_iterator p = traits::local(result);
+        ptrdiff_t n = traits::end(traits::segment(result)) - p;
+        if (last - first < n)
+            n = last - first;
+        mystl::copy(first, first + n, p);
+        first += n;
+        result += n;
+    }
+    return result;
+}
+
+template <typename InputIterator, typename OutputIterator>
+OutputIterator _copy_segmented(InputIterator first, InputIterator last, OutputIterator result,
+    _false_type, _false_type){
     return _copy(first, last, result, value_type(first));
 }
 
+template <typename InputIterator, typename SegmentedIterator>
+SegmentedIterator _copy_segmented(InputIterator first, InputIterator last, SegmentedIterator result,
+    _false_type, _true_type){
+    return _copy_to_segments(first, last, result);
+}
+
+//输入是分段迭代器时逐段复制，各段再按输出的段切分
+template <typename SegmentedIterator, typename OutputIterator, typename IsSegmented>
+OutputIterator _copy_segmented(SegmentedIterator first, SegmentedIterator last, OutputIterator result,
+    _true_type, IsSegmented){
+    typedef typename segmented_iterator_traits<SegmentedIterator>::local_iterator local_iterator;
+    _for_each_segment(first, last, [&result](local_iterator p, local_iterator q){
+        result = mystl::copy(p, q, result);
+    });
+    return result;
+}
+
+template <typename InputIterator, typename OutputIterator>
+OutputIterator copy(InputIterator first, InputIterator last, OutputIterator result){
+    typedef typename segmented_iterator_traits<InputIterator>::is_segmented_iterator in_segmented;
+    typedef typename segmented_iterator_traits<OutputIterator>::is_segmented_iterator out_segmented;
+    return _copy_segmented(first, last, result, in_segmented(), out_segmented());
+}
+
 template<>
 inline char *copy(char *first, char *last, char *result){
     auto dist = last - first;
-    memcpy(result, first, sizeof(*first) * dist);
+    memmove(result, first, sizeof(*first) * dist);
     return result + dist;
 }
 
 template<>
 inline wchar_t *copy(wchar_t *first, wchar_t *last, wchar_t *result){
     auto dist = last - first;
-    memcpy(result, first, sizeof(*first) * dist);
+    memmove(result, first, sizeof(*first) * dist);
     return result + dist;
 }
 
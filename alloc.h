@@ -1,47 +1,294 @@
 #ifndef MYSTL_ALLOC_H_
 #define MYSTL_ALLOC_H_
 
+#include <atomic> //for atomic
 #include <cstdlib>
+#include <iosfwd> //for ostream
+#include <mutex> //for mutex
 
 namespace mystl {
 
 //具备次配置力（内存池）的空间配置器
+//每个线程在中心内存池（depot）之前拥有一层私有的free-list缓存，
+//allocate/deallocate的快速路径只访问线程缓存，无需加锁；
+//线程缓存与中心内存池之间以BATCH_COUNT个区块为单位批量搬运
+//不超过32K的区块都由内存池管理：128字节以内按8字节分级，其上按几何级数分级
+//内存池以CHUNK_SIZE对齐的chunk为单位向系统申请，完全空闲的chunk可由trim()归还系统
+//开启大页arena后，chunk改从以透明大页映射的大块区域中切分，以减少TLB缺失
+//每个线程在缓存中记录自己的分配计数，get_stats/print_stats汇总所有线程得到统计信息
+//开启采样后，平均每分配sample_interval字节记录一次分配及其调用栈，用于定位内存占用的来源
+//allocate_chain/deallocate_chain成批分配与释放同样大小的区块，供节点型容器批量建立与销毁
+//每个线程从自己申请的chunk中切分区块，其他线程释放这些区块时以无锁方式压入所属线程的
+//远程释放队列，由所属线程在缓存为空时成批取回，生产者/消费者线程之间无需经过中心内存池
+//allocate_at_least返回区块的实际可用大小，vector/string等以此作为容量，减少扩容次数
+//allocate只保证MIN_ALIGN对齐，更大的2的幂对齐（如64字节缓存行）经allocate_aligned分配
 class alloc {
 
 private:
     enum { ALIGN = 8 }; //小型区块的上调边界
     enum { MAX_BYTES = 128 }; //小型区块的上限
-    enum { NFREELISTS = MAX_BYTES / ALIGN }; //free-lists个数
+    enum { NSMALLLISTS = MAX_BYTES / ALIGN }; //小型区块的free-lists个数
+    enum { MAX_POOLED_BYTES = 32 * 1024 }; //中型区块的上限，超过则调用第一级配置器
+    enum { CLASSES_PER_DOUBLING = 4 }; //中型区块每翻一倍划分的级数
+    enum { NFREELISTS = NSMALLLISTS + 8 * CLASSES_PER_DOUBLING }; //free-lists个数，(128, 32K]共8次翻倍
+    enum { BATCH_SIZE = 32 }; //线程缓存与中心内存池之间一次搬运的区块数上限
+    enum { BATCH_BYTES = 64 * 1024 }; //一次搬运的字节数上限，大区块据此减少搬运个数
+    enum { CHUNK_SIZE = 256 * 1024 }; //向系统申请内存的单位，起始地址按CHUNK_SIZE对齐
+    enum { DEFAULT_TRIM_THRESHOLD = 32 * CHUNK_SIZE }; //中心内存池空闲超过此值时自动trim
+    enum { HUGE_PAGE_SIZE = 2 * 1024 * 1024 }; //透明大页的大小
+    enum { ARENA_SIZE = 32 * HUGE_PAGE_SIZE }; //大页arena一次映射的区域大小
 private:
     static size_t ROUND_UP(size_t bytes) { //将butes上调至8的倍数
         return ((bytes + ALIGN - 1) & ~(ALIGN - 1));
     }
+    //第index个free-list的区块大小：
+    //小型区块以8字节递增，中型区块在每个(2^k, 2^(k+1)]区间内等分为4级
+    static size_t CLASS_SIZE(size_t index) {
+        if (index < NSMALLLISTS) return (index + 1) * ALIGN;
+        index -= NSMALLLISTS;
+        size_t shift = 7 + index / CLASSES_PER_DOUBLING;
+        return (static_cast<size_t>(1) << shift)
+            + (index % CLASSES_PER_DOUBLING + 1) * (static_cast<size_t>(1) << (shift - 2));
+    }
+    //第index个free-list一次搬运或切分的区块数
+    static size_t BATCH_COUNT(size_t index) {
+        size_t count = BATCH_BYTES / CLASS_SIZE(index);
+        return count > BATCH_SIZE ? BATCH_SIZE : (count < 2 ? 2 : count);
+    }
 private:
     union obj { //free-list节点
         union obj *free_list_link;
         char client_data[1];
     };
 private:
-    //16个free-lists
+    enum { CACHE_LINE_SIZE = 64 };
+    //远程释放队列：其他线程释放属于本线程chunk的区块时，以无锁方式压入对应级别的栈，
+    //所属线程在线程缓存为空时整栈取走；队列不随线程析构，线程退出后留待新线程接管
+    struct remote_slot {
+        std::atomic<obj *> head;
+        std::atomic<size_t> count; //栈中的区块数，先于压栈增加，因此不会小于实际值
+    };
+    struct alignas(CACHE_LINE_SIZE) remote_queue {
+        remote_slot slot[NFREELISTS];
+        remote_queue *next_orphan; //无主队列链表，受depot_mutex保护
+    };
+    //chunk头部，位于每个chunk的起始处，chunk之间以双向链表相连
+    struct chunk_header {
+        chunk_header *prev;
+        chunk_header *next;
+        size_t free_bytes; //trim时统计的空闲字节数
+        bool from_arena; //切分自大页arena的chunk不单独归还系统
+        std::atomic<size_t> sampled; //chunk中尚未释放的采样区块数，为0时释放无需查找采样记录
+        remote_queue *owner; //申请此chunk的线程的远程释放队列，0表示不属于任何线程
+    };
+    enum { CHUNK_HEADER_SIZE = (sizeof(chunk_header) + ALIGN - 1) & ~(ALIGN - 1) };
+    //区块所在的chunk，chunk按CHUNK_SIZE对齐，屏蔽低位即得chunk头部
+    static chunk_header *CHUNK_OF(const void *p) {
+        return reinterpret_cast<chunk_header *>(
+            reinterpret_cast<size_t>(p) & ~(static_cast<size_t>(CHUNK_SIZE) - 1));
+    }
+    //向系统申请一个新的chunk并挂入chunk链表，所属队列为owner，失败返回0
+    static char *chunk_acquire(remote_queue *owner);
+    //从大页arena切分一个chunk，arena用尽时映射新的区域，失败返回0
+    static char *arena_chunk();
+    //将chunk从链表摘除并归还系统
+    static void chunk_release(chunk_header *chunk);
+    //释放所有完全空闲的chunk，返回归还系统的字节数，需持有depot_mutex
+    static size_t trim_locked();
+private:
+    //统计计数器：只由所属线程修改，get_stats可在其他线程读取
+    //修改以relaxed的读和写完成，快速路径上没有加锁的读改写指令
+    class counter {
+    private:
+        std::atomic<size_t> value;
+    public:
+        constexpr counter() : value(0) {}
+        size_t get() const { return value.load(std::memory_order_relaxed); }
+        void set(size_t v) { value.store(v, std::memory_order_relaxed); }
+        size_t operator+=(size_t n) {
+            size_t v = get() + n;
+            value.store(v, std::memory_order_relaxed);
+            return v;
+        }
+        size_t operator-=(size_t n) { return *this += -n; }
+        size_t operator++() { return *this += 1; }
+        size_t operator--() { return *this -= 1; }
+        //多个线程可能同时修改时使用
+        void atomic_add(size_t n) { value.fetch_add(n, std::memory_order_relaxed); }
+    };
+    //一个线程的分配计数，跨线程释放时单个线程的差值可能“为负”，汇总后即为正确值
+    struct counters {
+        counter allocs[NFREELISTS];
+        counter frees[NFREELISTS];
+        counter requested_bytes; //存活区块的请求字节数
+        counter large_allocs; //超过MAX_POOLED_BYTES转交malloc的次数
+        counter large_frees;
+        counter large_bytes; //尚未释放的malloc字节数
+    };
+private:
+    //尚未切分的内存区域，受depot_mutex保护；每个线程从自己申请的chunk中切分新区块，
+    //使chunk的区块在释放时能找到所属线程
+    struct pool_region {
+        char *start_free; //起始位置，只在chunk_alloc变化
+        char *end_free; //结束位置，只在chunk_alloc变化
+        remote_queue *owner; //新chunk的所属队列
+    };
+private:
+    //线程私有的free-lists，线程退出时将缓存的区块全部归还中心内存池
+    //所有线程缓存以双向链表相连，供get_stats汇总
+    struct thread_cache {
+        obj *free_list[NFREELISTS];
+        counter length[NFREELISTS]; //每个free-list中的区块数，上限为2 * BATCH_COUNT
+        counters counts;
+        size_t bytes_until_sample; //距下一次采样还需分配的字节数
+        unsigned long long rng_state; //生成采样间隔的随机数状态
+        remote_queue *queue; //本线程的远程释放队列
+        pool_region pool; //本线程切分新区块的区域
+        //连续释放给同一队列、同一级别的区块先在此攒成一串，再以一次compare_exchange压入
+        obj *pending_first;
+        obj *pending_last;
+        remote_queue *pending_owner;
+        counter pending_index;
+        counter pending_length;
+        thread_cache *prev;
+        thread_cache *next;
+        thread_cache();
+        ~thread_cache();
+    };
+    static thread_cache& local_cache();
+    //当前线程的计数，线程缓存已析构时返回0
+    static counters *local_counters();
+private:
+    //第一级、第二级配置器的分配与释放，allocate/deallocate在其外层完成采样
+    static void *allocate_block(size_t n);
+    static void deallocate_block(void *p, size_t n);
+private:
+    static std::atomic<size_t> sample_interval; //平均采样间隔，0表示不采样
+    static std::atomic<size_t> live_samples; //尚未释放的采样数
+    static std::atomic<size_t> live_large_samples; //其中由malloc分配的采样数
+    //记录一次采样并抽取下一个采样间隔
+    static void record_sample(thread_cache& cache, void *p, size_t n);
+    //p为采样区块时删除其采样记录
+    static void forget_sample(void *p, size_t n);
+    //从中心内存池取出一批区块放入线程缓存，并返回其中一个，需持有depot_mutex
+    static void *fetch_from_depot(thread_cache& cache, size_t n);
+    //将线程缓存中的count个区块归还中心内存池，需持有depot_mutex
+    static void release_to_depot(thread_cache& cache, size_t index, size_t count);
+    //将first至last的count个区块整串压入owner的远程释放队列
+    static void push_remote(remote_queue *owner, size_t index, obj *first, obj *last, size_t count);
+    //将区块p交给所属队列owner，攒满一批或换了队列、级别时压入
+    static void free_remote(thread_cache& cache, remote_queue *owner, size_t index, obj *p);
+    //压入尚未压入的一串区块
+    static void flush_remote(thread_cache& cache);
+    //取走远程释放队列中第index级的全部区块，返回链首，队列为空时返回0
+    static obj *take_remote(remote_queue *queue, size_t index, obj *&last, size_t& count);
+    //将本线程远程释放队列中第index级的区块并入线程缓存，返回并入的区块数
+    static size_t drain_remote(thread_cache& cache, size_t index);
+    //取得一个远程释放队列，优先接管无主队列，需持有depot_mutex
+    static remote_queue *adopt_queue();
+    //向线程缓存第index个free-list补充count个区块，先取中心内存池，不足再从chunk切分，需持有depot_mutex
+    static void fill_cache_locked(thread_cache& cache, size_t index, size_t count);
+private:
+    //中心内存池的48个free-lists
     static obj *free_list[NFREELISTS];
     //根据区块大小决定使用第n个free-list, n从0开始计算
     static size_t FREELIST_INDEX(size_t bytes) {
-        return ((bytes + ALIGN - 1) / ALIGN - 1);
+        if (bytes <= MAX_BYTES) {
+            return ((bytes + ALIGN - 1) / ALIGN - 1);
+        }
+        //bytes落在(2^shift, 2^(shift+1)]区间，shift >= 7
+        size_t shift = 8 * sizeof(unsigned long) - 1 - __builtin_clzl(bytes - 1);
+        return NSMALLLISTS + (shift - 7) * CLASSES_PER_DOUBLING
+            + ((bytes - 1) >> (shift - 2)) - CLASSES_PER_DOUBLING;
     }
     //返回一个大小为n的对象，并可能加入大小为n的其他区块到free-list
-    static void *refill(size_t n);
-    //配置一大块空间，可容纳nobjs个大小为size的区块
+    static void *refill(size_t n, pool_region& pool);
+    //将内存池中不足一个区块的残余空间按级别拆分放入free-lists
+    static void reclaim_leftover(char *p, size_t bytes);
+    //从pool配置一大块空间，可容纳nobjs个大小为size的区块
     //如果配置nobjs个区块有所不便，nobjs可能会降低
-    static char *chunk_alloc(size_t size, int &nobjs);
+    static char *chunk_alloc(size_t size, int &nobjs, pool_region& pool);
 private:
-    static char *start_free; //内存池起始位置，只在chunk_alloc变化
-    static char *end_free; //内存池结束位置，只在chunk_alloc变化
-    static size_t heap_size;
+    static std::mutex depot_mutex; //保护中心内存池的所有static成员
+    static pool_region pool; //线程缓存析构后使用的内存池
+    static size_t heap_size; //当前持有的chunk总字节数
+    static chunk_header *chunk_list; //所有chunk组成的链表
+    static size_t depot_free_bytes; //中心内存池free-lists中的空闲字节数
+    static size_t trim_threshold;
+    static size_t trim_trigger; //depot_free_bytes达到此值时自动trim
+    static bool huge_page_arena; //新的chunk是否从大页arena切分
+    static char *arena_cur; //当前arena区域中尚未切分的起始位置
+    static char *arena_end;
+    static thread_cache *cache_list; //所有存活的线程缓存
+    static counters retired_counts; //已退出线程的计数，只以atomic_add修改
+    static remote_queue *orphan_queues; //线程退出后无主的远程释放队列
+
+public:
+    enum { MIN_ALIGN = ALIGN }; //allocate返回的地址保证的对齐
+    enum { NSIZECLASSES = NFREELISTS };
+    //某一级区块的统计
+    struct class_stats {
+        size_t block_size;
+        size_t allocs; //累计分配次数
+        size_t frees; //累计释放次数
+        size_t live; //尚未释放的区块数
+        size_t depot_free; //中心内存池free-list中的区块数
+        size_t cached_free; //各线程缓存free-list中的区块数
+        size_t remote_free; //各远程释放队列中的区块数
+    };
+    struct stats {
+        class_stats size_class[NSIZECLASSES];
+        size_t chunk_count; //持有的chunk数
+        size_t arena_chunk_count; //其中切分自大页arena的chunk数
+        size_t heap_size; //向系统申请的chunk总字节数
+        size_t requested_bytes; //存活区块的请求字节数
+        size_t live_bytes; //存活区块按级别大小计算的字节数
+        size_t free_bytes; //中心内存池与线程缓存中空闲区块的字节数
+        size_t large_allocs; //超过32K转交malloc的次数
+        size_t large_frees;
+        size_t large_bytes; //尚未释放的malloc字节数
+    };
 
 public:
     static void *allocate(size_t bytes);
     static void deallocate(void *p, size_t n);
+    //将p指向的old_sz字节区块调整为new_sz字节并保留内容，返回新地址，原地址此后失效
+    //大区块经realloc调整，可不经复制地扩展或移动；p为0时等同于allocate(new_sz)
     static void *reallocate(void *p, size_t old_sz, size_t new_sz);
+    //配置至少n个大小为size的对象，count返回区块实际可容纳的个数（不小于n）
+    //内存池区块按级别大小、malloc区块按其可用大小计算，释放时以count * size为大小
+    //n * size须大于0，供按元素计容量的容器把区块的余量记入容量
+    static void *allocate_at_least(size_t n, size_t size, size_t& count);
+    //分配按align对齐的n字节，align须为2的幂；超过MIN_ALIGN时多分配align字节，
+    //在其中取对齐的地址，并在对齐地址之前的一个字中保存原地址
+    static void *allocate_aligned(size_t n, size_t align);
+    //释放allocate_aligned得到的区块，n与align须与分配时相同
+    static void deallocate_aligned(void *p, size_t n, size_t align);
+    //一次分配count个大小为n的区块，区块以首个字相连成链，返回链首，链尾的链接为0
+    //n不得小于一个指针；线程缓存不足时只加锁一次，从中心内存池与chunk中补足
+    static void *allocate_chain(size_t n, size_t count);
+    //释放由allocate_chain或allocate得到、以首个字相连的count个大小为n的区块
+    static void deallocate_chain(void *first, size_t n, size_t count);
+    //将当前线程缓存与其远程释放队列归还中心内存池，并把完全空闲的chunk归还系统
+    //返回归还系统的字节数；其他线程缓存中的区块不参与统计
+    static size_t trim();
+    //设置自动trim的阈值，中心内存池新增的空闲字节超过bytes时自动trim，0表示关闭
+    static void set_trim_threshold(size_t bytes);
+    //开启或关闭大页arena，只影响此后新申请的chunk
+    //arena以MADV_HUGEPAGE建议内核使用透明大页，内核不支持时退化为普通页；
+    //arena无法映射时退化为普通chunk；arena中的chunk常驻内存池，trim不会释放
+    static void set_huge_page_arena(bool enable);
+    //汇总所有线程的计数与内存池状态，期间持有depot_mutex并遍历中心free-lists
+    static void get_stats(stats& s);
+    //以文本表格输出get_stats的结果，只列出用到过的级别
+    static void print_stats(std::ostream& os);
+    //开启采样堆分析，平均每分配bytes字节采样一次，0表示关闭
+    //采样间隔服从指数分布，关闭后已有的采样记录保留至对应区块释放
+    static void set_sample_interval(size_t bytes);
+    //以pprof兼容的heap profile格式（heap_v2）输出尚未释放的采样分配
+    static void write_heap_profile(std::ostream& os);
+    //以文本输出按调用栈汇总的尚未释放的采样分配，字节数已按采样概率放大
+    static void print_heap_profile(std::ostream& os);
 };
 
 }//namespace
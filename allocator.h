@@ -5,11 +5,98 @@
 #include "construct.h"
 
 #include <cstddef> //for size_t, ptrdiff_t
+#include <cstring> //for memcpy
 
 namespace mystl {
 
+//以下两个函数按align对齐配置与释放n字节，align须为2的幂
+//Alloc提供allocate_aligned/deallocate_aligned时交由其完成（int版本），
+//否则多配置align字节并在其中取对齐的地址，对齐地址之前的一个字保存原地址（long版本）
+template<typename Alloc>
+auto _allocate_aligned(Alloc& a, size_t n, size_t align, int)
+    -> decltype(a.allocate_aligned(n, align)) {
+    return a.allocate_aligned(n, align);
+}
+
+template<typename Alloc>
+void *_allocate_aligned(Alloc& a, size_t n, size_t align, long) {
+    if (align <= alloc::MIN_ALIGN) return a.allocate(n);
+    char *raw = static_cast<char *>(a.allocate(n + align));
+    if (raw == 0) return 0; //与allocate一样以0表示失败，不能在其前面写入原地址
+    char *aligned = reinterpret_cast<char *>(
+        (reinterpret_cast<size_t>(raw) + align) & ~(align - 1));
+    reinterpret_cast<void **>(aligned)[-1] = raw;
+    return aligned;
+}
+
+template<typename Alloc>
+auto _deallocate_aligned(Alloc& a, void *p, size_t n, size_t align, int)
+    -> decltype(a.deallocate_aligned(p, n, align)) {
+    a.deallocate_aligned(p, n, align);
+}
+
+template<typename Alloc>
+void _deallocate_aligned(Alloc& a, void *p, size_t n, size_t align, long) {
+    if (align <= alloc::MIN_ALIGN) a.deallocate(p, n);
+    else a.deallocate(reinterpret_cast<void **>(p)[-1], n + align);
+}
+
+template<typename Alloc>
+inline void *aligned_allocate(Alloc& a, size_t n, size_t align) {
+    return _allocate_aligned(a, n, align, 0);
+}
+
+template<typename Alloc>
+inline void aligned_deallocate(Alloc& a, void *p, size_t n, size_t align) {
+    _deallocate_aligned(a, p, n, align, 0);
+}
+
+//以下两个函数配置至少n个大小为size的对象，count返回实际可容纳的个数
+//Alloc提供allocate_at_least时交由其取得区块的全部可用空间（int版本），否则count等于n（long版本）
+template<typename Alloc>
+auto _allocate_at_least(Alloc& a, size_t n, size_t size, size_t& count, int)
+    -> decltype(a.allocate_at_least(n, size, count)) {
+    return a.allocate_at_least(n, size, count);
+}
+
+template<typename Alloc>
+void *_allocate_at_least(Alloc& a, size_t n, size_t size, size_t& count, long) {
+    count = n;
+    return a.allocate(n * size);
+}
+
+template<typename Alloc>
+inline void *policy_allocate_at_least(Alloc& a, size_t n, size_t size, size_t& count) {
+    return _allocate_at_least(a, n, size, count, 0);
+}
+
+//以下两个函数将old_sz字节的区块调整为new_sz字节并保留内容
+//Alloc提供reallocate时交由其完成（int版本），否则配置新区块、复制后释放原区块（long版本）
+template<typename Alloc>
+auto _reallocate(Alloc& a, void *p, size_t old_sz, size_t new_sz, int)
+    -> decltype(a.reallocate(p, old_sz, new_sz)) {
+    return a.reallocate(p, old_sz, new_sz);
+}
+
+template<typename Alloc>
+void *_reallocate(Alloc& a, void *p, size_t old_sz, size_t new_sz, long) {
+    void *result = a.allocate(new_sz);
+    memcpy(result, p, old_sz < new_sz ? old_sz : new_sz);
+    a.deallocate(p, old_sz);
+    return result;
+}
+
+template<typename Alloc>
+inline void *policy_reallocate(Alloc& a, void *p, size_t old_sz, size_t new_sz) {
+    return _reallocate(a, p, old_sz, new_sz, 0);
+}
+
+//Alloc是提供allocate/deallocate的配置策略，既可以是只有static成员的alloc，
+//也可以是带状态的对象（如resource_alloc）。allocator私有继承Alloc，
+//无状态的Alloc经空基类优化后不占空间；容器再私有继承allocator，每个实例携带自己的配置器
+//配置策略只保证alloc::MIN_ALIGN对齐，alignof(T)更大时经aligned_allocate配置
 template<typename T, typename Alloc>
-class allocator {
+class allocator : private Alloc {
 public:
     typedef T            value_type;
     typedef T*           pointer;
@@ -18,11 +105,64 @@ public:
     typedef const T&     const_reference;
     typedef size_t       size_type;
     typedef ptrdiff_t    difference_type;
+
+    //同一配置策略下其他类型的allocator
+    template<typename U>
+    struct rebind {
+        typedef allocator<U, Alloc> other;
+    };
 public:
-    static T *allocate();
-    static T *allocate(size_t n);
-    static void deallocate(T *p);
-    static void deallocate(T *p, size_t n);
+    allocator() {}
+    allocator(const Alloc& a) : Alloc(a) {}
+    template<typename U>
+    allocator(const allocator<U, Alloc>& a) : Alloc(a.policy()) {}
+
+    T *allocate();
+    T *allocate(size_t n);
+    void deallocate(T *p);
+    void deallocate(T *p, size_t n);
+    //配置至少n个T，count返回实际可容纳的个数，释放时以count为大小
+    //Alloc提供allocate_at_least时取得区块的全部可用空间，否则count等于n
+    T *allocate_at_least(size_t n, size_t& count);
+    //将p处old_n个T的区块调整为new_n个，按字节保留前min(old_n, new_n)个对象，只适用于可平凡重定位的T
+    //Alloc提供reallocate时交由其完成（大区块可不经复制地扩展），否则配置新区块并复制
+    T *reallocate(T *p, size_t old_n, size_t new_n);
+
+    //一次配置count个T，以每个对象的首个字串成链，Alloc提供allocate_chain时交由其批量完成
+    T *allocate_chain(size_t count);
+    //释放allocate_chain或allocate得到、以首个字串成链的count个T
+    void deallocate_chain(T *first, size_t count);
+    //读写链中的下一个对象，对象尚未构造或已经析构
+    static T *chain_next(T *p) { return *reinterpret_cast<T **>(p); }
+    static void set_chain_next(T *p, T *next) { *reinterpret_cast<T **>(p) = next; }
+
+    //取得配置策略对象
+    const Alloc& policy() const { return *this; }
+
+private:
+    enum { OVER_ALIGNED = alignof(T) > alloc::MIN_ALIGN };
+
+    T *copy_reallocate(T *p, size_t old_n, size_t new_n);
+    //Alloc有allocate_chain/deallocate_chain时选择int版本，否则退化为逐个配置的long版本
+    template<typename A>
+    auto policy_allocate_chain(A& a, size_t count, int)
+        -> decltype(a.allocate_chain(sizeof(T), count)) {
+        return a.allocate_chain(sizeof(T), count);
+    }
+    template<typename A>
+    void *policy_allocate_chain(A&, size_t count, long) { return allocate_each(count); }
+    template<typename A>
+    auto policy_deallocate_chain(A& a, T *first, size_t count, int)
+        -> decltype(a.deallocate_chain(first, sizeof(T), count)) {
+        a.deallocate_chain(first, sizeof(T), count);
+    }
+    template<typename A>
+    void policy_deallocate_chain(A&, T *first, size_t count, long) {
+        deallocate_each(first, count);
+    }
+    //逐个配置与释放链中的对象
+    T *allocate_each(size_t count);
+    void deallocate_each(T *first, size_t count);
 
     //static void construct(T *p);
     //static void construct(T *p, const T& value);
@@ -30,27 +170,206 @@ public:
     //static void destroy(T *first, T *last);
 };
 
+//Alloc::allocate为static时与直接调用相同，否则在本对象继承的Alloc上调用
 template<typename T, typename Alloc>
 T *allocator<T, Alloc>::allocate() {
+    if (OVER_ALIGNED)
+        return static_cast<T *>(aligned_allocate(static_cast<Alloc&>(*this), sizeof(T), alignof(T)));
     return static_cast<T *>(Alloc::allocate(sizeof(T)));
 }
 
 template<typename T, typename Alloc>
 T *allocator<T, Alloc>::allocate(size_t n) {
     if (n == 0) return 0;
+    if (OVER_ALIGNED)
+        return static_cast<T *>(aligned_allocate(static_cast<Alloc&>(*this), sizeof(T) * n, alignof(T)));
     return static_cast<T *>(Alloc::allocate(sizeof(T) * n));
 }
 
 template<typename T, typename Alloc>
 void allocator<T, Alloc>::deallocate(T *p) {
-    Alloc::deallocate(static_cast<void *>(p), sizeof(T));
+    if (OVER_ALIGNED)
+        aligned_deallocate(static_cast<Alloc&>(*this), static_cast<void *>(p), sizeof(T), alignof(T));
+    else
+        Alloc::deallocate(static_cast<void *>(p), sizeof(T));
 }
 
 template<typename T, typename Alloc>
 void allocator<T, Alloc>::deallocate(T *p, size_t n) {
-    if (n != 0)
+    if (n == 0) return;
+    if (OVER_ALIGNED)
+        aligned_deallocate(static_cast<Alloc&>(*this), static_cast<void *>(p), sizeof(T) * n, alignof(T));
+    else
         Alloc::deallocate(static_cast<void *>(p), sizeof(T) * n);
 }
+
+//超过MIN_ALIGN对齐的对象经aligned_allocate配置，不计余量
+template<typename T, typename Alloc>
+T *allocator<T, Alloc>::allocate_at_least(size_t n, size_t& count) {
+    if (n == 0 || OVER_ALIGNED) {
+        count = n;
+        return allocate(n);
+    }
+    return static_cast<T *>(policy_allocate_at_least(static_cast<Alloc&>(*this), n, sizeof(T), count));
+}
+
+//空区块与超过MIN_ALIGN对齐的对象不经Alloc::reallocate
+template<typename T, typename Alloc>
+T *allocator<T, Alloc>::reallocate(T *p, size_t old_n, size_t new_n) {
+    if (p == 0 || old_n == 0) return allocate(new_n);
+    if (new_n == 0) {
+        deallocate(p, old_n);
+        return 0;
+    }
+    if (OVER_ALIGNED) return copy_reallocate(p, old_n, new_n);
+    return static_cast<T *>(policy_reallocate(static_cast<Alloc&>(*this), p,
+                                              old_n * sizeof(T), new_n * sizeof(T)));
+}
+
+template<typename T, typename Alloc>
+T *allocator<T, Alloc>::copy_reallocate(T *p, size_t old_n, size_t new_n) {
+    T *result = allocate(new_n);
+    memcpy(static_cast<void *>(result), static_cast<void *>(p),
+           sizeof(T) * (old_n < new_n ? old_n : new_n));
+    deallocate(p, old_n);
+    return result;
+}
+
+//超过MIN_ALIGN对齐的对象不经Alloc的批量接口，逐个配置以保证对齐
+template<typename T, typename Alloc>
+T *allocator<T, Alloc>::allocate_chain(size_t count) {
+    static_assert(sizeof(T) >= sizeof(T *), "chain link does not fit in T");
+    if (count == 0) return 0;
+    if (OVER_ALIGNED) return allocate_each(count);
+    return static_cast<T *>(policy_allocate_chain(static_cast<Alloc&>(*this), count, 0));
+}
+
+template<typename T, typename Alloc>
+void allocator<T, Alloc>::deallocate_chain(T *first, size_t count) {
+    if (count == 0) return;
+    if (OVER_ALIGNED) deallocate_each(first, count);
+    else policy_deallocate_chain(static_cast<Alloc&>(*this), first, count, 0);
+}
+
+template<typename T, typename Alloc>
+T *allocator<T, Alloc>::allocate_each(size_t count) {
+    T *first = 0;
+    size_t got = 0;
+    try {
+        for ( ; got < count; ++got) {
+            T *p = allocate();
+            set_chain_next(p, first);
+            first = p;
+        }
+    } catch (...) {
+        deallocate_each(first, got);
+        throw;
+    }
+    return first;
+}
+
+template<typename T, typename Alloc>
+void allocator<T, Alloc>::deallocate_each(T *first, size_t count) {
+    for ( ; count > 0; --count) {
+        T *next = chain_next(first);
+        deallocate(first);
+        first = next;
+    }
+}
+
+//将Alloc包装为按Align对齐的配置策略，Align须为2的幂
+//例如vector<float, align_alloc<64> >的缓冲区可用对齐的SIMD加载，相邻容器的热点数据也不会共享缓存行
+template<size_t Align, typename Alloc = alloc>
+class align_alloc : private Alloc {
+    static_assert(Align != 0 && (Align & (Align - 1)) == 0, "Align must be a power of two");
+public:
+    enum { ALIGNMENT = Align };
+    align_alloc() {}
+    align_alloc(const Alloc& a) : Alloc(a) {}
+
+    void *allocate(size_t n) { return aligned_allocate(base(), n, Align); }
+    void deallocate(void *p, size_t n) { aligned_deallocate(base(), p, n, Align); }
+    //类型本身的对齐超过Align时取其中较大者
+    void *allocate_aligned(size_t n, size_t align) {
+        return aligned_allocate(base(), n, align > Align ? align : Align);
+    }
+    void deallocate_aligned(void *p, size_t n, size_t align) {
+        aligned_deallocate(base(), p, n, align > Align ? align : Align);
+    }
+
+    //取得被包装的配置策略对象
+    const Alloc& policy() const { return *this; }
+private:
+    Alloc& base() { return *this; }
+};
+
+//从allocator成批取得未构造的节点，逐个交给容器使用，析构时归还未用完的节点
+//expected为预计需要的节点数，0表示未知，此时每批的数目从MIN_BATCH起逐次翻倍
+template<typename T, typename Alloc>
+class node_batch_source {
+public:
+    enum { MIN_BATCH = 16, MAX_BATCH = 512 };
+    node_batch_source(allocator<T, Alloc>& a, size_t expected = 0)
+        : node_allocator(a), chain(0), left(0), expected(expected), batch(MIN_BATCH) {}
+    ~node_batch_source() { node_allocator.deallocate_chain(chain, left); }
+
+    T *get() {
+        if (left == 0) refill();
+        T *p = chain;
+        chain = allocator<T, Alloc>::chain_next(p);
+        --left;
+        return p;
+    }
+private:
+    void refill() {
+        size_t n;
+        if (expected != 0) {
+            n = expected < MAX_BATCH ? expected : MAX_BATCH;
+            expected -= n;
+        } else {
+            n = batch;
+            if (batch < MAX_BATCH) batch *= 2;
+        }
+        chain = node_allocator.allocate_chain(n);
+        left = n;
+    }
+
+    node_batch_source(const node_batch_source&);
+    node_batch_source& operator=(const node_batch_source&);
+private:
+    allocator<T, Alloc>& node_allocator;
+    T *chain; //尚未交出的节点
+    size_t left;
+    size_t expected; //预计仍需的节点数
+    size_t batch;
+};
+
+//收集已析构的节点，每攒满MAX_BATCH个以及析构时一次归还allocator
+template<typename T, typename Alloc>
+class node_batch_sink {
+public:
+    enum { MAX_BATCH = 512 };
+    explicit node_batch_sink(allocator<T, Alloc>& a) : node_allocator(a), chain(0), count(0) {}
+    ~node_batch_sink() { flush(); }
+
+    void put(T *p) {
+        allocator<T, Alloc>::set_chain_next(p, chain);
+        chain = p;
+        if (++count == MAX_BATCH) flush();
+    }
+    void flush() {
+        node_allocator.deallocate_chain(chain, count);
+        chain = 0;
+        count = 0;
+    }
+private:
+    node_batch_sink(const node_batch_sink&);
+    node_batch_sink& operator=(const node_batch_sink&);
+private:
+    allocator<T, Alloc>& node_allocator;
+    T *chain;
+    size_t count;
+};
 /*
 template<typename T, typename Alloc>
 void allocator<T, Alloc>::construct(T* p) {
@@ -0,0 +1,94 @@
+#ifndef MYSTL_ARENA_H_
+#define MYSTL_ARENA_H_
+
+#include <cstdlib>
+#include <cstring> //for memcpy
+
+namespace mystl {
+
+//单调递增的内存区域：从大块内存中顺序切分区块，单个区块不回收，
+//release()一次性归还全部内存，适合生命周期相同的一批对象
+class monotonic_arena {
+
+private:
+    enum { ALIGN = 8 }; //区块的上调边界，与alloc一致
+    enum { INITIAL_BLOCK_SIZE = 4 * 1024 }; //第一块内存的大小，此后每块翻倍
+    enum { MAX_BLOCK_SIZE = 1024 * 1024 }; //翻倍的上限，更大的请求单独申请
+private:
+    //每块内存的头部，所有内存块以单向链表相连，最新的在表头
+    struct block_header {
+        block_header *next;
+        size_t size; //含头部在内的大小
+    };
+    enum { BLOCK_HEADER_SIZE = (sizeof(block_header) + ALIGN - 1) & ~(ALIGN - 1) };
+private:
+    char *cur_; //当前内存块中尚未切分的起始位置
+    char *end_;
+    block_header *blocks_;
+    size_t next_block_size_; //下一块内存的大小
+    size_t bytes_allocated_; //已切分的字节数
+private:
+    //当前内存块不足时申请新的内存块并从中切分
+    void *allocate_slow(size_t bytes);
+    monotonic_arena(const monotonic_arena&);
+    monotonic_arena& operator=(const monotonic_arena&);
+
+public:
+    monotonic_arena() : cur_(0), end_(0), blocks_(0),
+        next_block_size_(INITIAL_BLOCK_SIZE), bytes_allocated_(0) {}
+    ~monotonic_arena();
+
+    void *allocate(size_t bytes) {
+        bytes = (bytes + ALIGN - 1) & ~(ALIGN - 1);
+        bytes_allocated_ += bytes;
+        if (static_cast<size_t>(end_ - cur_) >= bytes) {
+            void *result = cur_;
+            cur_ += bytes;
+            return result;
+        }
+        return allocate_slow(bytes);
+    }
+    //按align对齐切分，align须为2的幂；当前内存块放不下时多切分align字节再取对齐的地址
+    void *allocate(size_t bytes, size_t align) {
+        if (align <= ALIGN) return allocate(bytes);
+        size_t pad = -reinterpret_cast<size_t>(cur_) & (align - 1);
+        size_t rounded = (bytes + ALIGN - 1) & ~(ALIGN - 1);
+        if (static_cast<size_t>(end_ - cur_) >= pad + rounded) {
+            cur_ += pad;
+            bytes_allocated_ += pad;
+            return allocate(bytes);
+        }
+        char *p = static_cast<char *>(allocate(bytes + align));
+        return reinterpret_cast<char *>((reinterpret_cast<size_t>(p) + align - 1) & ~(align - 1));
+    }
+    //归还全部内存，只保留最近申请的一块供此后复用；之前切分的区块全部失效
+    void release();
+    //自上次release以来切分的字节数
+    size_t bytes_allocated() const { return bytes_allocated_; }
+};
+
+//以monotonic_arena作为Alloc策略，例如list<T, monotonic_alloc<Tag> >
+//每个线程拥有独立的arena，区块从当前线程的arena切分，deallocate不做任何事
+//请求结束、容器全部析构之后调用release()一次性归还内存；Tag用于区分互不相干的arena
+template<typename Tag = void>
+class monotonic_alloc {
+public:
+    static void *allocate(size_t n) { return arena().allocate(n); }
+    static void deallocate(void *, size_t) {}
+    static void *allocate_aligned(size_t n, size_t align) { return arena().allocate(n, align); }
+    static void deallocate_aligned(void *, size_t, size_t) {}
+    static void *reallocate(void *p, size_t old_sz, size_t new_sz) {
+        void *result = allocate(new_sz);
+        memcpy(result, p, old_sz < new_sz ? old_sz : new_sz);
+        return result;
+    }
+    static void release() { arena().release(); }
+    static monotonic_arena& arena() {
+        static thread_local monotonic_arena instance;
+        return instance;
+    }
+};
+
+}//namespace mystl
+
+#endif
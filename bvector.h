@@ -0,0 +1,600 @@
+#ifndef MYSTL_BVECTOR_H_
+#define MYSTL_BVECTOR_H_
+
+#include "allocator.h"
+#include "iterator.h"
+#include "vector.h"
+
+#include <algorithm> //for max, min
+#include <cstddef> //for size_t, ptrdiff_t
+#include <cstring> //for memset, memcmp
+#include <initializer_list> //for initializer_list
+#include <iostream> //for ostream
+#include <stdexcept> //for out_of_range
+#include <type_traits> //for is_integral
+#include <utility> //for swap
+
+namespace mystl {
+
+//vector<bool>以unsigned long为字逐位存放元素，每个元素只占1位
+//计数、查找、取反与按位运算均以整个字为单位进行
+typedef unsigned long _bit_word;
+enum { _WORD_BIT = int(sizeof(_bit_word) * 8) };
+
+//代理引用，指向某个字中的一位
+struct _bit_reference {
+    _bit_word *p;
+    _bit_word mask;
+    _bit_reference(_bit_word *x, _bit_word y) : p(x), mask(y) {}
+
+    operator bool() const { return (*p & mask) != 0; }
+    _bit_reference& operator=(bool x) {
+        if (x) *p |= mask;
+        else *p &= ~mask;
+        return *this;
+    }
+    _bit_reference& operator=(const _bit_reference& x) { return *this = bool(x); }
+    bool operator==(const _bit_reference& x) const { return bool(*this) == bool(x); }
+    bool operator<(const _bit_reference& x) const { return !bool(*this) && bool(x); }
+    void flip() { *p ^= mask; }
+};
+
+inline void swap(_bit_reference x, _bit_reference y) {
+    bool tmp = x;
+    x = y;
+    y = tmp;
+}
+
+//位迭代器的公共部分：所在的字与字内偏移
+struct _bit_iterator_base {
+    _bit_word *p;
+    unsigned int offset;
+    _bit_iterator_base(_bit_word *x, unsigned int y) : p(x), offset(y) {}
+
+    void bump_up() {
+        if (offset++ == _WORD_BIT - 1) {
+            offset = 0;
+            ++p;
+        }
+    }
+    void bump_down() {
+        if (offset-- == 0) {
+            offset = _WORD_BIT - 1;
+            --p;
+        }
+    }
+    void incr(ptrdiff_t i) {
+        ptrdiff_t n = i + offset;
+        p += n / _WORD_BIT;
+        n = n % _WORD_BIT;
+        if (n < 0) {
+            offset = static_cast<unsigned int>(n + _WORD_BIT);
+            --p;
+        } else {
+            offset = static_cast<unsigned int>(n);
+        }
+    }
+
+    bool operator==(const _bit_iterator_base& x) const {
+        return p == x.p && offset == x.offset;
+    }
+    bool operator!=(const _bit_iterator_base& x) const { return !(*this == x); }
+    bool operator<(const _bit_iterator_base& x) const {
+        return p < x.p || (p == x.p && offset < x.offset);
+    }
+    bool operator>(const _bit_iterator_base& x) const { return x < *this; }
+    bool operator<=(const _bit_iterator_base& x) const { return !(x < *this); }
+    bool operator>=(const _bit_iterator_base& x) const { return !(*this < x); }
+};
+
+inline ptrdiff_t operator-(const _bit_iterator_base& x, const _bit_iterator_base& y) {
+    return _WORD_BIT * (x.p - y.p) + static_cast<ptrdiff_t>(x.offset)
+        - static_cast<ptrdiff_t>(y.offset);
+}
+
+struct _bit_iterator : public _bit_iterator_base {
+    typedef random_access_iterator_tag  iterator_category;
+    typedef bool                        value_type;
+    typedef ptrdiff_t                   difference_type;
+    typedef _bit_reference*             pointer;
+    typedef _bit_reference              reference;
+    typedef _bit_iterator               iterator;
+
+    _bit_iterator() : _bit_iterator_base(0, 0) {}
+    _bit_iterator(_bit_word *x, unsigned int y) : _bit_iterator_base(x, y) {}
+
+    reference operator*() const { return reference(p, _bit_word(1) << offset); }
+    iterator& operator++() { bump_up(); return *this; }
+    iterator operator++(int) { iterator tmp = *this; bump_up(); return tmp; }
+    iterator& operator--() { bump_down(); return *this; }
+    iterator operator--(int) { iterator tmp = *this; bump_down(); return tmp; }
+    iterator& operator+=(difference_type i) { incr(i); return *this; }
+    iterator& operator-=(difference_type i) { incr(-i); return *this; }
+    iterator operator+(difference_type i) const { iterator tmp = *this; return tmp += i; }
+    iterator operator-(difference_type i) const { iterator tmp = *this; return tmp -= i; }
+    reference operator[](difference_type i) const { return *(*this + i); }
+};
+
+struct _bit_const_iterator : public _bit_iterator_base {
+    typedef random_access_iterator_tag  iterator_category;
+    typedef bool                        value_type;
+    typedef ptrdiff_t                   difference_type;
+    typedef const bool*                 pointer;
+    typedef bool                        reference;
+    typedef _bit_const_iterator         const_iterator;
+
+    _bit_const_iterator() : _bit_iterator_base(0, 0) {}
+    _bit_const_iterator(_bit_word *x, unsigned int y) : _bit_iterator_base(x, y) {}
+    _bit_const_iterator(const _bit_iterator& x) : _bit_iterator_base(x.p, x.offset) {}
+
+    reference operator*() const { return (*p & (_bit_word(1) << offset)) != 0; }
+    const_iterator& operator++() { bump_up(); return *this; }
+    const_iterator operator++(int) { const_iterator tmp = *this; bump_up(); return tmp; }
+    const_iterator& operator--() { bump_down(); return *this; }
+    const_iterator operator--(int) { const_iterator tmp = *this; bump_down(); return tmp; }
+    const_iterator& operator+=(difference_type i) { incr(i); return *this; }
+    const_iterator& operator-=(difference_type i) { incr(-i); return *this; }
+    const_iterator operator+(difference_type i) const {
+        const_iterator tmp = *this;
+        return tmp += i;
+    }
+    const_iterator operator-(difference_type i) const {
+        const_iterator tmp = *this;
+        return tmp -= i;
+    }
+    reference operator[](difference_type i) const { return *(*this + i); }
+};
+
+//vector<bool>的特化版本
+//已配置的字中位置不小于size()的位始终为0，count、rank与比较因此不必另行屏蔽末尾的字
+template<typename Alloc>
+class vector<bool, Alloc> : protected allocator<_bit_word, Alloc> {
+
+public:
+    typedef bool                    value_type;
+    typedef _bit_reference          reference;
+    typedef bool                    const_reference;
+    typedef _bit_reference*         pointer;
+    typedef const bool*             const_pointer;
+    typedef _bit_iterator           iterator;
+    typedef _bit_const_iterator     const_iterator;
+    typedef size_t                  size_type;
+    typedef ptrdiff_t               difference_type;
+    typedef Alloc                   allocator_type;
+
+    static const size_type npos = static_cast<size_type>(-1); //find未找到时的返回值
+
+protected:
+    typedef allocator<_bit_word, Alloc> data_allocator; //空间配置器
+
+    _bit_word *start_; //首个字
+    size_type size_; //元素（位）的个数
+    size_type words_; //已配置的字数
+
+    //容纳n位所需的字数
+    static size_type word_count(size_type n) { return (n + _WORD_BIT - 1) / _WORD_BIT; }
+    //低n位为1的字，n小于_WORD_BIT
+    static _bit_word low_mask(size_type n) {
+        return n == 0 ? 0 : ~_bit_word(0) >> (_WORD_BIT - n);
+    }
+    static int popcount(_bit_word w) { return __builtin_popcountl(w); }
+
+    bool get_bit(size_type n) const { return (start_[n / _WORD_BIT] >> (n % _WORD_BIT)) & 1; }
+    void set_bit(size_type n, bool x) {
+        _bit_word mask = _bit_word(1) << (n % _WORD_BIT);
+        if (x) start_[n / _WORD_BIT] |= mask;
+        else start_[n / _WORD_BIT] &= ~mask;
+    }
+    //从第pos位起的len位，len不大于_WORD_BIT，跨字时拼接相邻两个字的高低部分
+    _bit_word read_bits(size_type pos, size_type len) const;
+    //将w的低len位写入第pos位起的len位，其余位不变
+    void write_bits(size_type pos, _bit_word w, size_type len);
+    //将第from位起的n位搬移到第to位起，按源与目的的先后决定方向，区间可以重叠
+    void move_bits(size_type to, size_type from, size_type n);
+    //将[first, last)位置为x，首尾不足一字的部分用掩码，中间整字直接填充
+    void fill_bits(size_type first, size_type last, bool x);
+    //字都是平凡的，经配置器的reallocate调整为可容纳n位，新增的字清零
+    void reallocate_storage(size_type n);
+    //在第n位处空出count位，空出的位保留原值，由调用者设置；后面的位逐字搬移
+    void make_gap(size_type n, size_type count);
+    void deallocate() {
+        if (start_) data_allocator::deallocate(start_, words_);
+    }
+    void fill_initialize(size_type n, bool value);
+
+    template<typename Integer>
+    void range_initialize(Integer n, Integer value, std::true_type) {
+        fill_initialize(static_cast<size_type>(n), static_cast<bool>(value));
+    }
+    template<typename InputIterator>
+    void range_initialize(InputIterator first, InputIterator last, std::false_type) {
+        insert(end(), first, last);
+    }
+    template<typename Integer>
+    iterator insert_dispatch(iterator position, Integer n, Integer value, std::true_type) {
+        return insert(position, static_cast<size_type>(n), static_cast<bool>(value));
+    }
+    template<typename InputIterator>
+    iterator insert_dispatch(iterator position, InputIterator first, InputIterator last,
+                             std::false_type) {
+        return range_insert(position, first, last, iterator_category(first));
+    }
+    template<typename InputIterator>
+    iterator range_insert(iterator position, InputIterator first, InputIterator last,
+                          input_iterator_tag);
+    template<typename ForwardIterator>
+    iterator range_insert(iterator position, ForwardIterator first, ForwardIterator last,
+                          forward_iterator_tag);
+
+public:
+    //构造，析构，复制，移动相关函数
+    vector() : start_(0), size_(0), words_(0) {}
+    explicit vector(const allocator_type& a)
+        : data_allocator(a), start_(0), size_(0), words_(0) {}
+    vector(size_type n, bool value) { fill_initialize(n, value); }
+    vector(size_type n, bool value, const allocator_type& a)
+        : data_allocator(a) { fill_initialize(n, value); }
+    explicit vector(size_type n) { fill_initialize(n, false); }
+    //InputIterator为整数类型时等同于vector(n, value)
+    template<typename InputIterator>
+    vector(InputIterator first, InputIterator last) : start_(0), size_(0), words_(0) {
+        range_initialize(first, last, typename std::is_integral<InputIterator>::type());
+    }
+    vector(std::initializer_list<bool> values)
+        : vector(values.begin(), values.end()) {}
+    vector(const vector& vec);
+    vector(vector&& vec)
+        : data_allocator(vec.policy()), start_(vec.start_), size_(vec.size_), words_(vec.words_) {
+        vec.start_ = 0;
+        vec.size_ = vec.words_ = 0;
+    }
+    vector& operator=(vector vec) { //swap实现，既是拷贝也是移动赋值运算符
+        swap(vec);
+        return *this;
+    }
+    ~vector() { deallocate(); }
+
+    allocator_type get_allocator() const { return data_allocator::policy(); }
+
+    //比较相关操作，末尾的字中多余的位为0，可以逐字比较
+    bool operator==(const vector& vec) const {
+        return size_ == vec.size_
+            && std::memcmp(start_, vec.start_, word_count(size_) * sizeof(_bit_word)) == 0;
+    }
+    bool operator!=(const vector& vec) const { return !(*this == vec); }
+
+    //迭代器和容量相关
+    iterator begin() { return iterator(start_, 0); }
+    const_iterator begin() const { return const_iterator(start_, 0); }
+    const_iterator cbegin() const { return begin(); }
+    iterator end() { return begin() + static_cast<difference_type>(size_); }
+    const_iterator end() const { return begin() + static_cast<difference_type>(size_); }
+    const_iterator cend() const { return end(); }
+    size_type size() const { return size_; }
+    size_type capacity() const { return words_ * _WORD_BIT; }
+    bool empty() const { return size_ == 0; }
+    void resize(size_type n, bool value = false);
+    void reserve(size_type n) {
+        if (n > capacity()) reallocate_storage(n);
+    }
+    void shrink_to_fit() {
+        if (words_ > word_count(size_)) reallocate_storage(size_);
+    }
+
+    //访问元素相关
+    reference operator[](size_type n) {
+        return reference(start_ + n / _WORD_BIT, _bit_word(1) << (n % _WORD_BIT));
+    }
+    const_reference operator[](size_type n) const { return get_bit(n); }
+    reference at(size_type n) {
+        if (n >= size_) throw std::out_of_range("vector<bool>::at");
+        return (*this)[n];
+    }
+    const_reference at(size_type n) const {
+        if (n >= size_) throw std::out_of_range("vector<bool>::at");
+        return (*this)[n];
+    }
+    reference front() { return (*this)[0]; }
+    const_reference front() const { return (*this)[0]; }
+    reference back() { return (*this)[size_ - 1]; }
+    const_reference back() const { return (*this)[size_ - 1]; }
+
+    //操作容器相关
+    void clear() {
+        if (start_) std::memset(start_, 0, word_count(size_) * sizeof(_bit_word));
+        size_ = 0;
+    }
+    void swap(vector& vec) {
+        using std::swap;
+        swap(start_, vec.start_);
+        swap(size_, vec.size_);
+        swap(words_, vec.words_);
+        swap(static_cast<data_allocator&>(*this), static_cast<data_allocator&>(vec));
+    }
+    void push_back(bool value) {
+        if (size_ == capacity()) reallocate_storage(size_ == 0 ? size_type(_WORD_BIT) : 2 * size_);
+        set_bit(size_++, value);
+    }
+    void pop_back() { set_bit(--size_, false); }
+    iterator insert(iterator position, bool value) { return insert(position, 1, value); }
+    iterator insert(iterator position, size_type n, bool value);
+    template<typename InputIterator>
+    iterator insert(iterator position, InputIterator first, InputIterator last) {
+        return insert_dispatch(position, first, last,
+                               typename std::is_integral<InputIterator>::type());
+    }
+    iterator insert(iterator position, std::initializer_list<bool> lst) {
+        return insert(position, lst.begin(), lst.end());
+    }
+    iterator erase(iterator position) { return erase(position, position + 1); }
+    iterator erase(iterator first, iterator last);
+    template<typename InputIterator>
+    void assign(InputIterator first, InputIterator last) {
+        clear();
+        insert(end(), first, last);
+    }
+    void assign(std::initializer_list<bool> lst) { assign(lst.begin(), lst.end()); }
+    void assign(size_type n, bool value) {
+        clear();
+        insert(end(), n, value);
+    }
+
+    //逐字运算
+    //值为1的元素个数
+    size_type count() const;
+    //从第pos位起第一个值为value的元素的下标，不存在时返回npos
+    size_type find(bool value, size_type pos = 0) const;
+    //[0, pos)中值为1的元素个数，pos不大于size()，值为0的个数即pos - rank(pos)
+    size_type rank(size_type pos) const;
+    bool any() const { return find(true) != npos; }
+    bool none() const { return !any(); }
+    bool all() const { return find(false) == npos; }
+    //所有元素取反
+    void flip();
+    //与vec逐位运算，vec的长度须与本对象相同
+    vector& operator&=(const vector& vec);
+    vector& operator|=(const vector& vec);
+    vector& operator^=(const vector& vec);
+
+public:
+    //重载输出运算符
+    friend std::ostream& operator<<(std::ostream &os, const vector& vec) {
+        for (const_iterator first = vec.begin(); first != vec.end(); ++first) {
+            os << *first << " ";
+        }
+        return os;
+    }
+};
+
+template<typename Alloc>
+const typename vector<bool, Alloc>::size_type vector<bool, Alloc>::npos;
+
+//**********构造，析构相关**********
+template<typename Alloc>
+vector<bool, Alloc>::vector(const vector& vec)
+    : data_allocator(vec.policy()), start_(0), size_(0), words_(0) {
+    if (vec.size_ == 0) return;
+    start_ = data_allocator::allocate_at_least(word_count(vec.size_), words_);
+    std::memset(start_, 0, words_ * sizeof(_bit_word));
+    std::memcpy(start_, vec.start_, word_count(vec.size_) * sizeof(_bit_word));
+    size_ = vec.size_;
+}
+
+template<typename Alloc>
+void vector<bool, Alloc>::fill_initialize(size_type n, bool value) {
+    start_ = 0;
+    size_ = words_ = 0;
+    if (n == 0) return;
+    start_ = data_allocator::allocate_at_least(word_count(n), words_);
+    std::memset(start_, 0, words_ * sizeof(_bit_word));
+    size_ = n;
+    fill_bits(0, n, value);
+}
+
+//**********内部辅助函数**********
+template<typename Alloc>
+_bit_word vector<bool, Alloc>::read_bits(size_type pos, size_type len) const {
+    size_type i = pos / _WORD_BIT, offset = pos % _WORD_BIT;
+    _bit_word w = start_[i] >> offset;
+    if (offset + len > _WORD_BIT) w |= start_[i + 1] << (_WORD_BIT - offset);
+    return len == _WORD_BIT ? w : w & low_mask(len);
+}
+
+template<typename Alloc>
+void vector<bool, Alloc>::write_bits(size_type pos, _bit_word w, size_type len) {
+    size_type i = pos / _WORD_BIT, offset = pos % _WORD_BIT;
+    _bit_word mask = len == _WORD_BIT ? ~_bit_word(0) : low_mask(len);
+    w &= mask;
+    start_[i] = (start_[i] & ~(mask << offset)) | (w << offset);
+    if (offset + len > _WORD_BIT) { //高位部分写入下一个字
+        size_type rest = offset + len - _WORD_BIT;
+        start_[i + 1] = (start_[i + 1] & ~low_mask(rest)) | (w >> (_WORD_BIT - offset));
+    }
+}
+
+//向低位搬移时从前向后，向高位搬移时从后向前，每次读出的位在被覆盖前已经取走
+template<typename Alloc>
+void vector<bool, Alloc>::move_bits(size_type to, size_type from, size_type n) {
+    if (to == from || n == 0) return;
+    if (to < from) {
+        for (size_type k = 0; k < n; k += _WORD_BIT) {
+            size_type len = std::min<size_type>(_WORD_BIT, n - k);
+            write_bits(to + k, read_bits(from + k, len), len);
+        }
+    } else {
+        for (size_type k = n; k > 0; ) {
+            size_type len = std::min<size_type>(_WORD_BIT, k);
+            k -= len;
+            write_bits(to + k, read_bits(from + k, len), len);
+        }
+    }
+}
+
+template<typename Alloc>
+void vector<bool, Alloc>::fill_bits(size_type first, size_type last, bool x) {
+    if (first == last) return;
+    size_type first_word = first / _WORD_BIT, last_word = last / _WORD_BIT;
+    _bit_word head = ~low_mask(first % _WORD_BIT), tail = low_mask(last % _WORD_BIT);
+    if (first_word == last_word) {
+        head &= tail;
+        if (x) start_[first_word] |= head;
+        else start_[first_word] &= ~head;
+        return;
+    }
+    if (x) start_[first_word] |= head;
+    else start_[first_word] &= ~head;
+    if (last_word > first_word + 1)
+        std::memset(start_ + first_word + 1, x ? 0xff : 0,
+                    (last_word - first_word - 1) * sizeof(_bit_word));
+    if (tail) {
+        if (x) start_[last_word] |= tail;
+        else start_[last_word] &= ~tail;
+    }
+}
+
+template<typename Alloc>
+void vector<bool, Alloc>::reallocate_storage(size_type n) {
+    size_type new_words = word_count(n);
+    if (new_words == words_) return;
+    start_ = data_allocator::reallocate(start_, words_, new_words);
+    if (new_words > words_)
+        std::memset(start_ + words_, 0, (new_words - words_) * sizeof(_bit_word));
+    words_ = new_words;
+}
+
+template<typename Alloc>
+void vector<bool, Alloc>::make_gap(size_type n, size_type count) {
+    if (size_ + count > capacity())
+        reallocate_storage(std::max(size_ + count, 2 * size_));
+    move_bits(n + count, n, size_ - n);
+    size_ += count;
+}
+
+//**********操作容器相关**********
+template<typename Alloc>
+void vector<bool, Alloc>::resize(size_type n, bool value) {
+    if (n < size_) erase(begin() + static_cast<difference_type>(n), end());
+    else insert(end(), n - size_, value);
+}
+
+template<typename Alloc>
+typename vector<bool, Alloc>::iterator
+vector<bool, Alloc>::insert(iterator position, size_type n, bool value) {
+    size_type index = static_cast<size_type>(position - begin());
+    if (n != 0) {
+        make_gap(index, n);
+        fill_bits(index, index + n, value);
+    }
+    return begin() + static_cast<difference_type>(index);
+}
+
+template<typename Alloc>
+template<typename InputIterator>
+typename vector<bool, Alloc>::iterator
+vector<bool, Alloc>::range_insert(iterator position, InputIterator first, InputIterator last,
+                                  input_iterator_tag) {
+    size_type index = static_cast<size_type>(position - begin());
+    if (index == size_) { //在尾部插入时逐个push_back即可
+        for ( ; first != last; ++first) push_back(*first);
+        return begin() + static_cast<difference_type>(index);
+    }
+    vector buf(get_allocator()); //长度未知，先读入临时的vector<bool>，再只搬移一次原有元素
+    for ( ; first != last; ++first) buf.push_back(*first);
+    if (buf.size_ != 0) {
+        make_gap(index, buf.size_);
+        for (size_type k = 0; k < buf.size_; k += _WORD_BIT) {
+            size_type len = std::min<size_type>(_WORD_BIT, buf.size_ - k);
+            write_bits(index + k, buf.start_[k / _WORD_BIT], len);
+        }
+    }
+    return begin() + static_cast<difference_type>(index);
+}
+
+//前向迭代器区间先求出长度，只搬移一次原有元素
+template<typename Alloc>
+template<typename ForwardIterator>
+typename vector<bool, Alloc>::iterator
+vector<bool, Alloc>::range_insert(iterator position, ForwardIterator first, ForwardIterator last,
+                                  forward_iterator_tag) {
+    size_type index = static_cast<size_type>(position - begin());
+    size_type n = 0;
+    for (ForwardIterator it = first; it != last; ++it) ++n;
+    if (n != 0) {
+        make_gap(index, n);
+        for (size_type i = index; first != last; ++first, ++i) set_bit(i, *first);
+    }
+    return begin() + static_cast<difference_type>(index);
+}
+
+template<typename Alloc>
+typename vector<bool, Alloc>::iterator
+vector<bool, Alloc>::erase(iterator first, iterator last) {
+    size_type from = static_cast<size_type>(first - begin());
+    size_type to = static_cast<size_type>(last - begin());
+    size_type new_size = size_ - (to - from);
+    move_bits(from, to, size_ - to);
+    fill_bits(new_size, size_, false); //保持末尾多余的位为0
+    size_ = new_size;
+    return begin() + static_cast<difference_type>(from);
+}
+
+//**********逐字运算**********
+template<typename Alloc>
+typename vector<bool, Alloc>::size_type vector<bool, Alloc>::count() const {
+    size_type result = 0;
+    for (size_type i = 0, n = word_count(size_); i != n; ++i) result += popcount(start_[i]);
+    return result;
+}
+
+//查找0时将字取反，末尾多余的位取反后为1，找到的下标不小于size()时即不存在
+template<typename Alloc>
+typename vector<bool, Alloc>::size_type
+vector<bool, Alloc>::find(bool value, size_type pos) const {
+    if (pos >= size_) return npos;
+    _bit_word inverse = value ? 0 : ~_bit_word(0);
+    size_type i = pos / _WORD_BIT, n = word_count(size_);
+    _bit_word w = (start_[i] ^ inverse) & ~low_mask(pos % _WORD_BIT);
+    while (w == 0) {
+        if (++i == n) return npos;
+        w = start_[i] ^ inverse;
+    }
+    size_type result = i * _WORD_BIT + __builtin_ctzl(w);
+    return result < size_ ? result : npos;
+}
+
+template<typename Alloc>
+typename vector<bool, Alloc>::size_type vector<bool, Alloc>::rank(size_type pos) const {
+    size_type result = 0, full = pos / _WORD_BIT;
+    for (size_type i = 0; i != full; ++i) result += popcount(start_[i]);
+    if (pos % _WORD_BIT) result += popcount(start_[full] & low_mask(pos % _WORD_BIT));
+    return result;
+}
+
+template<typename Alloc>
+void vector<bool, Alloc>::flip() {
+    size_type n = word_count(size_);
+    for (size_type i = 0; i != n; ++i) start_[i] = ~start_[i];
+    if (size_ % _WORD_BIT) start_[n - 1] &= low_mask(size_ % _WORD_BIT);
+}
+
+template<typename Alloc>
+vector<bool, Alloc>& vector<bool, Alloc>::operator&=(const vector& vec) {
+    for (size_type i = 0, n = word_count(size_); i != n; ++i) start_[i] &= vec.start_[i];
+    return *this;
+}
+
+template<typename Alloc>
+vector<bool, Alloc>& vector<bool, Alloc>::operator|=(const vector& vec) {
+    for (size_type i = 0, n = word_count(size_); i != n; ++i) start_[i] |= vec.start_[i];
+    return *this;
+}
+
+template<typename Alloc>
+vector<bool, Alloc>& vector<bool, Alloc>::operator^=(const vector& vec) {
+    for (size_type i = 0, n = word_count(size_); i != n; ++i) start_[i] ^= vec.start_[i];
+    return *this;
+}
+
+} //namespace mystl
+
+#endif
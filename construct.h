@@ -1,7 +1,10 @@
 #ifndef MYSTL_CONSTRUCT_H_
 #define MYSTL_CONSTRUCT_H_
 
+#include <cstddef> //for size_t
 #include <new>
+#include <type_traits> //for remove_cv, remove_reference
+#include <utility> //for forward
 #include "typetraits.h"
 
 namespace mystl {
@@ -11,6 +14,12 @@ inline void construct(T1 *p, const T2& value) {
     new(p) T1(value); //placement new
 }
 
+//以任意参数就地构造，右值参数经forward转发后移动构造
+template<typename T, typename... Args>
+inline void construct(T *p, Args&&... args) {
+    new(p) T(std::forward<Args>(args)...);
+}
+
 //destroy的第一版本，接受一个指针
 template<typename T>
 inline void destroy(T *p) {
@@ -28,12 +37,45 @@ inline void _destroy(ForwardIterator first, ForwardIterator last, _false_type) {
         destroy(&*first);
 }
 
+//按元素类型而非迭代器类型判断，指针迭代器指向的对象同样需要析构
 template <typename ForwardIterator>
 inline void destroy(ForwardIterator first, ForwardIterator last) {
-    typedef typename _type_traits<ForwardIterator>::has_trivial_destructor trivial_destructor;
+    typedef typename std::remove_cv<
+        typename std::remove_reference<decltype(*first)>::type>::type value_type;
+    typedef typename _type_traits<value_type>::has_trivial_destructor trivial_destructor;
     _destroy(first, last, trivial_destructor()); //注意，传入的trivial_destructor是一个临时对象
 }
 
+//默认初始化标签：容器以此构造或扩大时，新增的元素只做默认初始化，
+//平凡类型的元素不写入任何值，适合随后会被整体覆盖的缓冲区
+struct default_init_t {};
+const default_init_t default_init = default_init_t();
+
+//在未初始化的first处默认初始化n个对象，返回末尾
+template<typename T>
+inline T *_uninitialized_default_n(T *first, size_t n, _true_type) {
+    return first + n;
+}
+
+template<typename T>
+T *_uninitialized_default_n(T *first, size_t n, _false_type) {
+    T *cur = first;
+    try {
+        for ( ; n > 0; --n, ++cur)
+            new(static_cast<void *>(cur)) T; //不带括号，平凡类型不做零初始化
+    } catch(...) {
+        destroy(first, cur);
+        throw;
+    }
+    return cur;
+}
+
+template<typename T>
+inline T *uninitialized_default_n(T *first, size_t n) {
+    typedef typename _type_traits<T>::has_trivial_default_constructor trivial_constructor;
+    return _uninitialized_default_n(first, n, trivial_constructor());
+}
+
 } //namespace mystl
 
 #endif
@@ -1,4 +1,4 @@
-#ifndef MUSTL_DEQUE_H_
+#ifndef MYSTL_DEQUE_H_
 #define MYSTL_DEQUE_H_
 
 #include "allocator.h"
@@ -16,9 +16,22 @@
 
 namespace mystl {
 
-//**********防止不同编译器在处理常量表达式时的bug**********
-inline size_t _deque_buf_size(size_t n, size_t sz) {
-    return n != 0 ? n : (sz < 512 ? static_cast<size_t>(512 / sz) : static_cast<size_t>(1));
+//**********缓冲区大小**********
+//缓冲区的目标字节数，可对特定类型特化以调整
+template<typename T>
+struct deque_buffer_bytes {
+    static constexpr size_t value = 512;
+};
+
+constexpr size_t _floor_log2(size_t n) { return n <= 1 ? 0 : 1 + _floor_log2(n >> 1); }
+constexpr size_t _ceil_log2(size_t n) { return n <= 1 ? 0 : 1 + _floor_log2(n - 1); }
+
+//每个缓冲区的元素个数是2的幂，迭代器以移位和掩码代替除法与取模
+//BufSiz不为0时向上取为2的幂，否则取不超过deque_buffer_bytes<T>字节的最大的2的幂（至少为1）
+template<typename T, size_t BufSiz>
+constexpr size_t _deque_buf_shift() {
+    return BufSiz != 0 ? _ceil_log2(BufSiz)
+        : _floor_log2(deque_buffer_bytes<T>::value / sizeof(T));
 }
 
 //**********deque iterator**********
@@ -26,7 +39,8 @@ template<typename T, typename Ref, typename Ptr, size_t BufSiz>
 struct _deque_iterator {
     typedef _deque_iterator<T, T&, T*, BufSiz>                iterator;
     typedef _deque_iterator<T, const T&, const T*, BufSiz>    const_iterator;
-    static size_t buffer_size() { return _deque_buf_size(BufSiz, sizeof(T)); }
+    static constexpr size_t buffer_shift() { return _deque_buf_shift<T, BufSiz>(); }
+    static constexpr size_t buffer_size() { return size_t(1) << buffer_shift(); }
 
     typedef random_access_iterator_tag    iterator_category; // STL标准强制要求
     typedef T                             value_type;        // STL标准强制要求
@@ -89,19 +103,17 @@ struct _deque_iterator {
         return tmp;
     }
 
+    //缓冲区大小是2的幂，有符号数算术右移即向下取整的除法，掩码即非负的余数
     self& operator+=(difference_type n) {
         difference_type offset = n + (cur - first);
         if (offset >= 0 && offset < static_cast<difference_type>(buffer_size())) {
             cur += n;
         }
         else {
-            difference_type node_offset =
-                offset > 0 ? offset / static_cast<difference_type>(buffer_size())
-                : -static_cast<difference_type>((-offset - 1) / buffer_size()) -1;
             //切换至正确的节点
-            set_node(node + node_offset);
+            set_node(node + (offset >> buffer_shift()));
             //切换至正确的元素
-            cur = first + (offset - node_offset * static_cast<difference_type>(buffer_size()));
+            cur = first + (offset & static_cast<difference_type>(buffer_size() - 1));
         }
         return *this;
     }
@@ -135,9 +147,28 @@ struct _deque_iterator {
     }
 }; // struct _deque_iterator
 
+//deque的迭代器是分段迭代器，每个缓冲区为一段
+template<typename T, typename Ref, typename Ptr, size_t BufSiz>
+struct segmented_iterator_traits<_deque_iterator<T, Ref, Ptr, BufSiz>> {
+    typedef _true_type                          is_segmented_iterator;
+    typedef _deque_iterator<T, Ref, Ptr, BufSiz> iterator;
+    typedef typename iterator::map_pointer      segment_iterator;
+    typedef Ptr                                 local_iterator;
+
+    static segment_iterator segment(const iterator& it) { return it.node; }
+    static local_iterator local(const iterator& it) { return it.cur; }
+    static local_iterator begin(segment_iterator s) { return *s; }
+    static local_iterator end(segment_iterator s) { return *s + iterator::buffer_size(); }
+    //p须在[begin(s), end(s))之内
+    static iterator compose(segment_iterator s, local_iterator p) {
+        return iterator(const_cast<T*>(p), s);
+    }
+};
+
 //**********class deque**********
+//deque私有继承缓冲区的空间配置器，map的配置器在使用时由其转换而来
 template<typename T, typename Alloc = alloc, size_t  BufSiz = 0>
-class deque {
+class deque : private allocator<T, Alloc> {
 public:
     typedef T                    value_type;
     typedef value_type*          pointer;
@@ -146,6 +177,7 @@ public:
     typedef const value_type&    const_reference;
     typedef size_t               size_type;
     typedef ptrdiff_t            difference_type;
+    typedef Alloc                allocator_type;
 
 public:
     typedef _deque_iterator<T, T&, T*, BufSiz>                iterator;
@@ -156,18 +188,22 @@ protected:
     typedef allocator<value_type, Alloc>    data_allocator; // deque空间配置器
     typedef allocator<pointer, Alloc>       map_allocator;
 
-    // 获取缓冲区最大存储元素数量
-    static size_type buffer_size() {
-        return _deque_buf_size(BufSiz, sizeof(value_type));
-    }
+    // 获取缓冲区最大存储元素数量，是2的幂
+    static constexpr size_type buffer_shift() { return iterator::buffer_shift(); }
+    static constexpr size_type buffer_size() { return iterator::buffer_size(); }
 
     static size_type initial_map_size() { return 8; }
 
+    //缓存的空闲缓冲区个数上限，首尾在缓冲区边界附近来回时不必反复配置与释放
+    enum { SPARE_NODES = 2 };
+
 protected:
     iterator start; // 起始缓冲区
     iterator finish; // 最后一个缓冲区
     map_pointer map; // 指向map的指针
     size_type map_size; // map容量
+    pointer spare_nodes[SPARE_NODES]; // 释放后留待复用的缓冲区
+    size_type spare_count = 0;
 
 public:
     // 构造，析构和移动，复制相关等
@@ -175,19 +211,35 @@ public:
         create_map_and_nodes(0);
     }
 
-    deque(const deque& x) : start(), finish(), map(0), map_size(0) {
+    explicit deque(const allocator_type& a)
+        : data_allocator(a), start(), finish(), map(0), map_size(0) {
+        create_map_and_nodes(0);
+    }
+
+    // 沿用x的配置器
+    deque(const deque& x)
+        : data_allocator(x), start(), finish(), map(0), map_size(0) {
         create_map_and_nodes(x.size());
         std::uninitialized_copy(x.begin(), x.end(), start);
     }
 
-    // 移动构造函数
-    deque(deque&& x) : start(x.start), finish(x.finish), map(x.map), map_size(x.map_size) {}
+    // 移动构造函数，x留下一个空的map以便正常析构
+    deque(deque&& x)
+        : data_allocator(x), start(), finish(), map(0), map_size(0) {
+        create_map_and_nodes(0);
+        swap(x);
+    }
 
     deque(size_type n, const value_type& value)
         : start(), finish(), map(0), map_size(0) {
         fill_initialize(n, value);
     }
 
+    deque(size_type n, const value_type& value, const allocator_type& a)
+        : data_allocator(a), start(), finish(), map(0), map_size(0) {
+        fill_initialize(n, value);
+    }
+
     deque(int n, const value_type& value)
         : start(), finish(), map(0), map_size(0) {
         fill_initialize(n, value);
@@ -235,17 +287,22 @@ public:
     */
 
 public:
+    allocator_type get_allocator() const { return data_allocator::policy(); }
+
     // 访问容器元素和大小相关
     iterator begin() { return start; }
     iterator end() { return finish; }
     const_iterator begin() const { return start; }
     const_iterator end() const { return finish; }
 
+    // 从起始缓冲区的首个位置算起，移位得到节点，掩码得到节点内的位置
     reference operator[](size_type n) {
-        return start[static_cast<difference_type>(n)];
+        n += start.cur - start.first;
+        return start.node[n >> buffer_shift()][n & (buffer_size() - 1)];
     }
     const_reference operator[](size_type n) const {
-        return start[static_cast<difference_type>(n)];
+        n += start.cur - start.first;
+        return start.node[n >> buffer_shift()][n & (buffer_size() - 1)];
     }
 
     reference front() { return *start; }
@@ -272,6 +329,9 @@ public:
         std::swap(finish, x.finish);
         std::swap(map, x.map);
         std::swap(map_size, x.map_size);
+        std::swap(spare_nodes, x.spare_nodes); // 缓冲区随配置器交换
+        std::swap(spare_count, x.spare_count);
+        std::swap(static_cast<data_allocator&>(*this), static_cast<data_allocator&>(x));
     }
 
     void push_back(const value_type& t) {
@@ -392,12 +452,23 @@ protected:
 
     void deallocate_map(size_type nodes_to_add, bool add_at_front);
 
-    pointer allocate_node() { // 分配内存，不进行构造
+    map_allocator get_map_allocator() const {
+        return map_allocator(static_cast<const data_allocator&>(*this));
+    }
+
+    pointer allocate_node() { // 分配内存，不进行构造，优先复用缓存的缓冲区
+        if (spare_count != 0) return spare_nodes[--spare_count];
         return data_allocator::allocate(buffer_size());
     }
 
-    void deallocate_node(pointer n) {
-        data_allocator::deallocate(n, buffer_size());
+    void deallocate_node(pointer n) { // 缓存未满时留待复用
+        if (spare_count != SPARE_NODES) spare_nodes[spare_count++] = n;
+        else data_allocator::deallocate(n, buffer_size());
+    }
+
+    void release_spare_nodes() {
+        while (spare_count != 0)
+            data_allocator::deallocate(spare_nodes[--spare_count], buffer_size());
     }
 }; // class deque
 
@@ -405,8 +476,9 @@ protected:
 template<typename T, typename Alloc, size_t BufSiz>
 void deque<T, Alloc, BufSiz>::create_map_and_nodes(size_type n) {
     size_type num_nodes = n / buffer_size() + 1;
-    map_size = std::max(initial_map_size(), num_nodes + 2); // 最小为8
-    map = map_allocator::allocate(map_size);
+    // 最小为8，map区块的余量也计入map_size
+    map = get_map_allocator().allocate_at_least(
+        std::max(initial_map_size(), num_nodes + 2), map_size);
     // 将[nstart, nfinish)分配在map的中间
     map_pointer nstart = map + (map_size - num_nodes) / 2;
     map_pointer nfinish = nstart + num_nodes - 1;
@@ -420,7 +492,8 @@ void deque<T, Alloc, BufSiz>::create_map_and_nodes(size_type n) {
     catch(...) {
         for(map_pointer n = nstart; n < cur; ++n)
             deallocate_node(*n);
-        map_allocator::deallocate(map, map_size);
+        release_spare_nodes();
+        get_map_allocator().deallocate(map, map_size);
         throw;
     }
 
@@ -434,7 +507,8 @@ template<typename T, typename Alloc, size_t BufSiz>
 void deque<T, Alloc, BufSiz>::destroy_map_and_nodes() {
     for (map_pointer cur = start.node; cur <= finish.node; ++cur)
         deallocate_node(*cur);
-    map_allocator::deallocate(map, map_size);
+    release_spare_nodes();
+    get_map_allocator().deallocate(map, map_size);
 }
 
 template<typename T, typename Alloc, size_t BufSiz>
@@ -714,11 +788,11 @@ void deque<T, Alloc, BufSize>::reallocate_map(size_type nodes_to_add
     }
     else {
         size_type new_map_size = map_size + std::max(map_size, nodes_to_add) + 2;
-        map_pointer new_map = map_allocator::allocate(new_map_size);
+        map_pointer new_map = get_map_allocator().allocate_at_least(new_map_size, new_map_size);
         new_nstart = new_map + (new_map_size - new_num_nodes) / 2
                          + (add_at_front ? nodes_to_add : 0);
         std::copy(start.node, finish.node + 1, new_nstart);
-        map_allocator::deallocate(map, map_size);
+        get_map_allocator().deallocate(map, map_size);
         map = new_map;
         map_size = new_map_size;
     }
@@ -824,14 +898,14 @@ deque<T, Alloc, BufSiz>::erase(iterator first, iterator last) {
             iterator new_start = start + n;
             destroy(start, new_start);
             for (map_pointer cur = start.node; cur < new_start.node; ++cur)
-                data_allocator::deallocate(*cur, buffer_size());
+                deallocate_node(*cur);
             start = new_start;
         } else {
             std::copy(last, finish, first);
             iterator new_finish = finish - n;
             destroy(new_finish, finish);
             for (map_pointer cur = new_finish.node + 1; cur <= finish.node; ++cur)
-                data_allocator::deallocate(*cur, buffer_size());
+                deallocate_node(*cur);
             finish = new_finish;
         }
         return start + elems_before;
@@ -843,17 +917,17 @@ void deque<T, Alloc, BufSiz>::clear() {
     //　首先析构起点到终点的所有元素，并释放相应空间
     for (map_pointer node = start.node + 1; node < finish.node; ++node) {
         destroy(*node, *node + buffer_size());
-        data_allocator::deallocate(*node, buffer_size());
+        deallocate_node(*node);
     }
     // 如果deque本身不为空，析构所有对象，并释放掉结尾内存
     if (start.node != finish.node) {
         destroy(start.cur, start.last);
         destroy(finish.first, finish.cur);
-        data_allocator::deallocate(finish.first, buffer_size());
+        deallocate_node(finish.first);
     }
     // 析构所有元素，但不释放空间
     else
-        destroy(start, finish.cur);
+        destroy(start.cur, finish.cur);
 
     finish = start;
 }
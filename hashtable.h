@@ -127,9 +127,10 @@ inline unsigned long next_prime(unsigned long n) {
 // ExtractKey:  从节点中取出键值的方法
 // EqualKey:    判断键值是否相同的方法
 // Alloc:       allocator, 默认为alloc（见前置声明）
+// hashtable私有继承节点的空间配置器，buckets使用同一配置策略
 template<typename Value, typename Key, typename HashFcn,
          typename ExtractKey, typename EqualKey, typename Alloc>
-class hashtable {
+class hashtable : private allocator<_hashtable_node<Value>, Alloc> {
 public:
     typedef Key                  key_type;
     typedef Value                value_type;
@@ -141,6 +142,7 @@ public:
     typedef const value_type*    const_pointer;
     typedef value_type&          reference;
     typedef const value_type&    const_reference;
+    typedef Alloc                allocator_type;
 
     hasher hash_funct() const { return hash; }
     key_equal key_eq() const { return equals; }
@@ -174,8 +176,16 @@ public:
         initialize_buckets(n);
     }
 
+    hashtable(size_type n, const HashFcn& hf, const EqualKey& eql, const allocator_type& a)
+        : node_allocator(a), hash(hf), equals(eql), get_key(ExtractKey()),
+          buckets(a), num_elements(0) {
+        initialize_buckets(n);
+    }
+
+    // 沿用ht的配置器
     hashtable(const hashtable& ht)
-        : hash(ht.hash), equals(ht.equals), get_key(ht.get_key), num_elements(0) {
+        : node_allocator(ht), hash(ht.hash), equals(ht.equals), get_key(ht.get_key),
+          buckets(ht.get_allocator()), num_elements(0) {
         copy_from(ht);
     }
 
@@ -203,8 +213,11 @@ public:
         std::swap(get_key, ht.get_key);
         buckets.swap(ht.buckets);
         std::swap(num_elements, ht.num_elements);
+        std::swap(static_cast<node_allocator&>(*this), static_cast<node_allocator&>(ht));
     }
 
+    allocator_type get_allocator() const { return node_allocator::policy(); }
+
     iterator begin() {
         for (size_type n = 0; n < buckets.size(); ++n)
             if (buckets[n])
@@ -254,9 +267,15 @@ public:
     }
 
     pair<iterator, bool>
-    insert_unique_noresize(const value_type& obj);
+    insert_unique_noresize(const value_type& obj) {
+        node_creator gen(*this);
+        return insert_unique_noresize(obj, gen);
+    }
 
-    iterator insert_equal_noresize(const value_type& obj);
+    iterator insert_equal_noresize(const value_type& obj) {
+        node_creator gen(*this);
+        return insert_equal_noresize(obj, gen);
+    }
 
     template <typename InputIterator>
     void insert_unique(InputIterator f, InputIterator l) {
@@ -268,18 +287,25 @@ public:
         insert_equal(f, l, iterator_category(f));
     }
 
+    // 区间插入的节点成批配置
     template <typename InputIterator>
     void insert_unique(InputIterator f, InputIterator l,
                        input_iterator_tag) {
-        for ( ; f != l; ++f)
-            insert_unique(*f);
+        batch_node_creator gen(*this, 0);
+        for ( ; f != l; ++f) {
+            resize(num_elements + 1);
+            insert_unique_noresize(*f, gen);
+        }
     }
 
     template <typename InputIterator>
     void insert_equal(InputIterator f, InputIterator l,
                       input_iterator_tag) {
-        for ( ; f != l; ++f)
-            insert_equal(*f);
+        batch_node_creator gen(*this, 0);
+        for ( ; f != l; ++f) {
+            resize(num_elements + 1);
+            insert_equal_noresize(*f, gen);
+        }
     }
 
     template <typename ForwardIterator>
@@ -287,8 +313,9 @@ public:
                        forward_iterator_tag) {
         size_type n = std::distance(f, l);
         resize(num_elements + n);
+        batch_node_creator gen(*this, n);
         for ( ; n > 0; --n, ++f)
-            insert_unique_noresize(*f);
+            insert_unique_noresize(*f, gen);
     }
 
     template <typename ForwardIterator>
@@ -296,8 +323,9 @@ public:
                       forward_iterator_tag) {
         size_type n = std::distance(f, l);
         resize(num_elements + n);
+        batch_node_creator gen(*this, n);
         for ( ; n > 0; --n, ++f)
-            insert_equal_noresize(*f);
+            insert_equal_noresize(*f, gen);
     }
 
     reference find_or_insert(const value_type& obj);
@@ -377,8 +405,10 @@ public:
     }
 
     // 分配空间并进行构造
-    node* new_node(const value_type& obj) {
-        node* n = node_allocator::allocate();
+    node* new_node(const value_type& obj) { return new_node(node_allocator::allocate(), obj); }
+
+    // 在已分配的节点n上进行构造，构造失败时释放n
+    node* new_node(node* n, const value_type& obj) {
         n->next = 0;
         try {
             construct(&n->val, obj);
@@ -400,6 +430,31 @@ public:
     void erase_bucket(const size_type n, node* last);
 
     void copy_from(const hashtable& ht);
+
+    // 以下两个函数对象为插入和复制生成节点：
+    // node_creator逐个配置节点，batch_node_creator从成批配置的节点中取用，用于区间插入和复制
+    class node_creator {
+    public:
+        explicit node_creator(hashtable& t) : table(t) {}
+        node* operator()(const value_type& obj) { return table.new_node(obj); }
+    private:
+        hashtable& table;
+    };
+
+    class batch_node_creator {
+    public:
+        batch_node_creator(hashtable& t, size_type expected)
+            : table(t), batch(static_cast<node_allocator&>(t), expected) {}
+        node* operator()(const value_type& obj) { return table.new_node(batch.get(), obj); }
+    private:
+        hashtable& table;
+        node_batch_source<node, Alloc> batch;
+    };
+
+    template <typename NodeGen>
+    pair<iterator, bool> insert_unique_noresize(const value_type& obj, NodeGen& gen);
+    template <typename NodeGen>
+    iterator insert_equal_noresize(const value_type& obj, NodeGen& gen);
 }; // class hashtable
 
 // 以下是struct _hashtable_iterator的实现
@@ -477,8 +532,9 @@ inline void swap(hashtable<Val, Key, HF, Extract, EqKey, A>& ht1,
 
 // 在不需要重新调整容量的情况下插入元素, key不可以重复
 template <typename V, typename K, typename HF, typename Ex, typename Eq, typename A>
+template <typename NodeGen>
 pair<typename hashtable<V, K, HF, Ex, Eq, A>::iterator, bool>
-hashtable<V, K, HF, Ex, Eq, A>::insert_unique_noresize(const value_type& obj) {
+hashtable<V, K, HF, Ex, Eq, A>::insert_unique_noresize(const value_type& obj, NodeGen& gen) {
     // 获取待插入元素在hashtable中的索引
     const size_type n = bkt_num(obj);
 
@@ -490,7 +546,7 @@ hashtable<V, K, HF, Ex, Eq, A>::insert_unique_noresize(const value_type& obj) {
             return pair<iterator, bool>(iterator(cur, this), false);
 
     // 插入结点
-    node* tmp = new_node(obj);
+    node* tmp = gen(obj);
     tmp->next = first;
     buckets[n] = tmp;
     ++num_elements;
@@ -499,21 +555,22 @@ hashtable<V, K, HF, Ex, Eq, A>::insert_unique_noresize(const value_type& obj) {
 
 // 在不需要重新调整容量的情况下插入元素, key可以重复
 template <typename V, typename K, typename HF, typename Ex, typename Eq, typename A>
+template <typename NodeGen>
 typename hashtable<V, K, HF, Ex, Eq, A>::iterator
-hashtable<V, K, HF, Ex, Eq, A>::insert_equal_noresize(const value_type& obj) {
+hashtable<V, K, HF, Ex, Eq, A>::insert_equal_noresize(const value_type& obj, NodeGen& gen) {
     const size_type n = bkt_num(obj);
     node* first = buckets[n];
 
     for (node* cur = first; cur; cur = cur->next)
         if (equals(get_key(cur->val), get_key(obj))) {
-            node* tmp = new_node(obj);
+            node* tmp = gen(obj);
             tmp->next = cur->next;
             cur->next = tmp;
             ++num_elements;
             return iterator(tmp, this);
         }
 
-    node* tmp = new_node(obj);
+    node* tmp = gen(obj);
     tmp->next = first;
     buckets[n] = tmp;
     ++num_elements;
@@ -699,7 +756,7 @@ void hashtable<V, K, HF, Ex, Eq, A>::resize(size_type num_elements_hint) {
         // 如果已经到达hashtable的容量的极限, 那么也不进行更改
         if (n > old_n) {
             // 建立新的线性表来扩充容量
-            vector<node*, A> tmp(n, (node*) 0);
+            vector<node*, A> tmp(n, (node*) 0, get_allocator());
             try {
                 // 先面开始copy
                 for (size_type bucket = 0; bucket < old_n; ++bucket) {
@@ -763,11 +820,13 @@ void hashtable<V, K, HF, Ex, Eq, A>::erase_bucket(const size_type n, node* last)
 // 清空hashtable, 但是不释放vector的内存
 template <typename V, typename K, typename HF, typename Ex, typename Eq, typename A>
 void hashtable<V, K, HF, Ex, Eq, A>::clear() {
+    node_batch_sink<node, A> sink(*this);
     for (size_type i = 0; i < buckets.size(); ++i) {
         node* cur = buckets[i];
         while (cur != 0) {
             node* next = cur->next;
-            delete_node(cur);
+            destroy(&cur->val);
+            sink.put(cur);
             cur = next;
         }
         buckets[i] = 0;
@@ -785,14 +844,15 @@ void hashtable<V, K, HF, Ex, Eq, A>::copy_from(const hashtable& ht) {
     // 完成初始化操作, 这是hashtable的先验条件
     buckets.insert(buckets.end(), ht.buckets.size(), (node*) 0);
     try {
-        // 开始copy操作
+        // 开始copy操作，节点按ht的元素个数成批配置
+        batch_node_creator gen(*this, ht.num_elements);
         for (size_type i = 0; i < ht.buckets.size(); ++i) {
             if (const node* cur = ht.buckets[i]) {
-                node* copy = new_node(cur->val);
+                node* copy = gen(cur->val);
                 buckets[i] = copy;
 
                 for (node* next = cur->next; next; cur = next, next = cur->next) {
-                    copy->next = new_node(next->val);
+                    copy->next = gen(next->val);
                     copy = copy->next;
                 }
             }
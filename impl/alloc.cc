@@ -1,61 +1,832 @@
 #include "../alloc.h"
 
+#include <algorithm> //for sort
+#include <climits> //for INT_MAX
+#include <cstring> //for memcpy
+#include <cmath> //for exp, log
+#include <execinfo.h> //for backtrace, backtrace_symbols
+#include <fstream> //for ifstream
+#include <iomanip> //for setw
+#include <malloc.h> //for malloc_usable_size
+#include <map>
+#include <new> //for bad_alloc
+#include <ostream> //for ostream
+#include <sys/mman.h> //for mmap, munmap, madvise
+#include <unordered_map>
+#include <utility> //for pair
+#include <vector>
+
 namespace mystl {
 
 //static data member的定义和初始值设定
-char *alloc::start_free = 0;
-char *alloc::end_free = 0;
+std::mutex alloc::depot_mutex;
+alloc::pool_region alloc::pool = { 0, 0, 0 };
 size_t alloc::heap_size = 0;
+alloc::chunk_header *alloc::chunk_list = 0;
+size_t alloc::depot_free_bytes = 0;
+size_t alloc::trim_threshold = alloc::DEFAULT_TRIM_THRESHOLD;
+size_t alloc::trim_trigger = alloc::DEFAULT_TRIM_THRESHOLD;
+bool alloc::huge_page_arena = false;
+char *alloc::arena_cur = 0;
+char *alloc::arena_end = 0;
+alloc::thread_cache *alloc::cache_list = 0;
+alloc::counters alloc::retired_counts;
+alloc::remote_queue *alloc::orphan_queues = 0;
+std::atomic<size_t> alloc::sample_interval(0);
+std::atomic<size_t> alloc::live_samples(0);
+std::atomic<size_t> alloc::live_large_samples(0);
+
+alloc::obj *alloc::free_list[alloc::NFREELISTS] = { 0 };
 
-alloc::obj *alloc::free_list[alloc::NFREELISTS] = {
-    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0
+//线程缓存析构后（线程退出阶段仍可能有释放操作）置为true，此后直接使用中心内存池
+static thread_local bool cache_destroyed = false;
+
+//一次采样记录
+struct heap_sample {
+    enum { MAX_STACK_DEPTH = 32 }; //记录的调用栈深度上限
+    size_t size; //请求字节数
+    size_t interval; //采样时的平均采样间隔
+    int depth;
+    void *stack[MAX_STACK_DEPTH];
 };
 
+//以区块地址为键的采样记录，容器经由malloc分配内存，不会递归进入alloc
+//有意不析构，以便线程退出和静态对象析构期间的释放仍可查找
+static std::mutex sample_mutex;
+static std::unordered_map<void *, heap_sample> *sample_map() {
+    static std::unordered_map<void *, heap_sample> *samples =
+        new std::unordered_map<void *, heap_sample>;
+    return samples;
+}
+
+//映射size + align大小的区域，再解除首尾多余部分，得到按align对齐的size字节，失败返回0
+static char *map_aligned(size_t size, size_t align) {
+    size_t map_size = size + align;
+    void *region = mmap(0, map_size, PROT_READ | PROT_WRITE,
+                        MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (region == MAP_FAILED) return 0;
+
+    char *begin = static_cast<char *>(region);
+    char *aligned = reinterpret_cast<char *>(
+        (reinterpret_cast<size_t>(begin) + align - 1) & ~(align - 1));
+    if (aligned != begin) {
+        munmap(begin, aligned - begin);
+    }
+    if (aligned + size != begin + map_size) {
+        munmap(aligned + size, begin + map_size - (aligned + size));
+    }
+    return aligned;
+}
+
+alloc::thread_cache::thread_cache() {
+    for (int i = 0; i < NFREELISTS; ++i) {
+        free_list[i] = 0;
+    }
+    bytes_until_sample = 0;
+    rng_state = reinterpret_cast<size_t>(this) | 1;
+    std::lock_guard<std::mutex> lock(depot_mutex);
+    queue = adopt_queue();
+    pool.start_free = pool.end_free = 0;
+    pool.owner = queue;
+    pending_first = pending_last = 0;
+    pending_owner = 0;
+    prev = 0;
+    next = cache_list;
+    if (cache_list) cache_list->prev = this;
+    cache_list = this;
+}
+
+//归还缓存的区块与尚未切分的区域，并把本线程的计数并入retired_counts
+//此后压入远程释放队列的区块留给接管队列的线程或trim处理
+alloc::thread_cache::~thread_cache() {
+    flush_remote(*this);
+    std::lock_guard<std::mutex> lock(depot_mutex);
+    for (int i = 0; i < NFREELISTS; ++i) {
+        drain_remote(*this, i);
+        release_to_depot(*this, i, length[i].get());
+        retired_counts.allocs[i].atomic_add(counts.allocs[i].get());
+        retired_counts.frees[i].atomic_add(counts.frees[i].get());
+    }
+    retired_counts.requested_bytes.atomic_add(counts.requested_bytes.get());
+    retired_counts.large_allocs.atomic_add(counts.large_allocs.get());
+    retired_counts.large_frees.atomic_add(counts.large_frees.get());
+    retired_counts.large_bytes.atomic_add(counts.large_bytes.get());
+
+    reclaim_leftover(pool.start_free, pool.end_free - pool.start_free);
+    pool.start_free = pool.end_free = 0;
+    queue->next_orphan = orphan_queues;
+    orphan_queues = queue;
+
+    if (prev) prev->next = next;
+    else cache_list = next;
+    if (next) next->prev = prev;
+    cache_destroyed = true;
+}
+
+alloc::thread_cache& alloc::local_cache() {
+    static thread_local thread_cache cache;
+    return cache;
+}
+
+alloc::counters *alloc::local_counters() {
+    return cache_destroyed ? 0 : &local_cache().counts;
+}
+
+//采样关闭时只多出一次relaxed读
 void *alloc::allocate(size_t n) {
-    if (n > MAX_BYTES) { //大于128就调用第一级配置器
-        return malloc(n);
+    void *result = allocate_block(n);
+    if (sample_interval.load(std::memory_order_relaxed) != 0 && !cache_destroyed) {
+        thread_cache& cache = local_cache();
+        if (n >= cache.bytes_until_sample) {
+            record_sample(cache, result, n);
+        } else {
+            cache.bytes_until_sample -= n;
+        }
     }
+    return result;
+}
 
-    obj **my_free_list, *result;
-    my_free_list = free_list + FREELIST_INDEX(n); //寻找16个free-list中适当的一个;
-    result = *my_free_list;
+void alloc::deallocate(void *p, size_t n) {
+    if (live_samples.load(std::memory_order_relaxed) != 0) {
+        forget_sample(p, n);
+    }
+    deallocate_block(p, n);
+}
+
+void *alloc::allocate_block(size_t n) {
+    if (n > MAX_POOLED_BYTES) { //大于32K就调用第一级配置器
+        void *result = malloc(n);
+        if (counters *counts = local_counters()) {
+            ++counts->large_allocs;
+            counts->large_bytes += n;
+        } else {
+            retired_counts.large_allocs.atomic_add(1);
+            retired_counts.large_bytes.atomic_add(n);
+        }
+        return result;
+    }
+
+    if (cache_destroyed) { //线程缓存已析构，直接从中心内存池取
+        size_t index = FREELIST_INDEX(n);
+        retired_counts.allocs[index].atomic_add(1);
+        retired_counts.requested_bytes.atomic_add(n);
+        std::lock_guard<std::mutex> lock(depot_mutex);
+        obj **my_free_list = free_list + index;
+        obj *result = *my_free_list;
+        if (result == 0) {
+            return refill(CLASS_SIZE(index), pool);
+        }
+        *my_free_list = result->free_list_link;
+        depot_free_bytes -= CLASS_SIZE(index);
+        return result;
+    }
+
+    thread_cache& cache = local_cache();
+    size_t index = FREELIST_INDEX(n); //寻找48个free-list中适当的一个
+    obj *result = cache.free_list[index];
+    ++cache.counts.allocs[index];
+    cache.counts.requested_bytes += n;
 
     if (result == 0) {
-        //没有找到可用的free-list,准备重新填充free-list
-        void *r = refill(ROUND_UP(n));
-        return r;
+        //线程缓存为空，先取回其他线程释放的区块，仍没有时从中心内存池批量取得
+        if (drain_remote(cache, index) == 0) {
+            std::lock_guard<std::mutex> lock(depot_mutex);
+            return fetch_from_depot(cache, CLASS_SIZE(index));
+        }
+        result = cache.free_list[index];
     }
 
-    *my_free_list = result->free_list_link; //重新调整free-list
+    cache.free_list[index] = result->free_list_link; //重新调整free-list
+    --cache.length[index];
     return result;
 }
 
-void alloc::deallocate(void *p, size_t n) {
-    if (n > MAX_BYTES) { //大于128就调用第一级配置器
+void alloc::deallocate_block(void *p, size_t n) {
+    if (n > MAX_POOLED_BYTES) { //大于32K就调用第一级配置器
         free(p);
+        if (counters *counts = local_counters()) {
+            ++counts->large_frees;
+            counts->large_bytes -= n;
+        } else {
+            retired_counts.large_frees.atomic_add(1);
+            retired_counts.large_bytes.atomic_add(-n);
+        }
         return;
     }
-    //寻找对应的free-list
-    obj **my_free_list;
-    my_free_list = free_list + FREELIST_INDEX(n);
+
+    size_t index = FREELIST_INDEX(n);
     obj *q = static_cast<obj *>(p);
-    q->free_list_link = *my_free_list;
-    *my_free_list = q;
+
+    if (cache_destroyed) { //线程缓存已析构，直接归还中心内存池
+        retired_counts.frees[index].atomic_add(1);
+        retired_counts.requested_bytes.atomic_add(-n);
+        std::lock_guard<std::mutex> lock(depot_mutex);
+        q->free_list_link = free_list[index];
+        free_list[index] = q;
+        depot_free_bytes += CLASS_SIZE(index);
+        return;
+    }
+
+    thread_cache& cache = local_cache();
+    ++cache.counts.frees[index];
+    cache.counts.requested_bytes -= n;
+    //属于其他线程的区块压入所属线程的远程释放队列
+    remote_queue *owner = CHUNK_OF(p)->owner;
+    if (owner != cache.queue && owner != 0) {
+        free_remote(cache, owner, index, q);
+        return;
+    }
+    //放入线程缓存对应的free-list
+    q->free_list_link = cache.free_list[index];
+    cache.free_list[index] = q;
+    if (++cache.length[index] > 2 * BATCH_COUNT(index)) {
+        //线程缓存过长，将一批区块归还中心内存池
+        std::lock_guard<std::mutex> lock(depot_mutex);
+        release_to_depot(cache, index, BATCH_COUNT(index));
+    }
 }
 
+//两端都是malloc区块时交给realloc：glibc对mmap得到的大区块以mremap移动页表，不复制数据
+//同一级别的内存池区块原地返回；其余情况配置新区块，复制内容后释放原区块
 void *alloc::reallocate(void *p, size_t old_sz, size_t new_sz) {
+    if (p == 0) return allocate(new_sz);
+    if (old_sz > MAX_POOLED_BYTES && new_sz > MAX_POOLED_BYTES) {
+        if (live_samples.load(std::memory_order_relaxed) != 0) {
+            forget_sample(p, old_sz); //区块可能移动，原地址的采样记录随之失效
+        }
+        void *result = realloc(p, new_sz);
+        if (result == 0) throw std::bad_alloc(); //原区块仍然有效
+        if (counters *counts = local_counters()) {
+            counts->large_bytes += new_sz - old_sz;
+        } else {
+            retired_counts.large_bytes.atomic_add(new_sz - old_sz);
+        }
+        return result;
+    }
+    if (old_sz <= MAX_POOLED_BYTES && new_sz <= MAX_POOLED_BYTES
+        && FREELIST_INDEX(old_sz) == FREELIST_INDEX(new_sz)) {
+        if (counters *counts = local_counters()) {
+            counts->requested_bytes += new_sz - old_sz;
+        } else {
+            retired_counts.requested_bytes.atomic_add(new_sz - old_sz);
+        }
+        return p;
+    }
+    void *result = allocate(new_sz);
+    memcpy(result, p, old_sz < new_sz ? old_sz : new_sz);
     deallocate(p, old_sz);
-    p = allocate(new_sz);
-    return p;
+    return result;
+}
+
+//内存池区块取所在级别的全部大小；malloc区块在glibc下取malloc_usable_size，
+//多出的字节补记入large_bytes，使释放时按count * size扣除后统计仍然平衡
+void *alloc::allocate_at_least(size_t n, size_t size, size_t& count) {
+    size_t bytes = n * size;
+    if (bytes <= MAX_POOLED_BYTES) {
+        count = CLASS_SIZE(FREELIST_INDEX(bytes)) / size;
+        return allocate(count * size);
+    }
+    void *result = allocate(bytes);
+    count = n;
+#ifdef __GLIBC__
+    if (result != 0) {
+        count = malloc_usable_size(result) / size;
+        size_t extra = (count - n) * size;
+        if (counters *counts = local_counters()) {
+            counts->large_bytes += extra;
+        } else {
+            retired_counts.large_bytes.atomic_add(extra);
+        }
+    }
+#endif
+    return result;
+}
+
+//分配的地址按ALIGN对齐，向上取到下一个align的倍数，前面至少空出一个字
+void *alloc::allocate_aligned(size_t n, size_t align) {
+    if (align <= ALIGN) return allocate(n);
+    char *raw = static_cast<char *>(allocate(n + align));
+    if (raw == 0) return 0; //与allocate一样以0表示失败，不能在其前面写入原地址
+    char *aligned = reinterpret_cast<char *>(
+        (reinterpret_cast<size_t>(raw) + align) & ~(align - 1));
+    reinterpret_cast<void **>(aligned)[-1] = raw;
+    return aligned;
+}
+
+void alloc::deallocate_aligned(void *p, size_t n, size_t align) {
+    if (align <= ALIGN) deallocate(p, n);
+    else deallocate(reinterpret_cast<void **>(p)[-1], n + align);
+}
+
+//大区块、线程退出阶段或开启采样时逐个分配，以保持各自的统计与采样语义
+void *alloc::allocate_chain(size_t n, size_t count) {
+    if (count == 0) return 0;
+    if (n > MAX_POOLED_BYTES || cache_destroyed
+        || sample_interval.load(std::memory_order_relaxed) != 0) {
+        obj *first = 0;
+        try {
+            for (size_t i = 0; i < count; ++i) {
+                obj *q = static_cast<obj *>(allocate(n));
+                q->free_list_link = first;
+                first = q;
+            }
+        } catch (...) {
+            while (first) {
+                obj *next = first->free_list_link;
+                deallocate(first, n);
+                first = next;
+            }
+            throw;
+        }
+        return first;
+    }
+
+    thread_cache& cache = local_cache();
+    size_t index = FREELIST_INDEX(n);
+    if (cache.length[index].get() < count) {
+        drain_remote(cache, index);
+    }
+    if (cache.length[index].get() < count) {
+        std::lock_guard<std::mutex> lock(depot_mutex);
+        fill_cache_locked(cache, index, count - cache.length[index].get());
+    }
+
+    //从线程缓存的链首整段摘下count个区块
+    obj *first = cache.free_list[index];
+    obj *last = first;
+    for (size_t i = 1; i < count; ++i) {
+        last = last->free_list_link;
+    }
+    cache.free_list[index] = last->free_list_link;
+    last->free_list_link = 0;
+    cache.length[index] -= count;
+    cache.counts.allocs[index] += count;
+    cache.counts.requested_bytes += n * count;
+    return first;
+}
+
+void alloc::deallocate_chain(void *first, size_t n, size_t count) {
+    if (first == 0 || count == 0) return;
+    obj *q = static_cast<obj *>(first);
+    if (n > MAX_POOLED_BYTES || cache_destroyed
+        || live_samples.load(std::memory_order_relaxed) != 0) {
+        for (size_t i = 0; i < count; ++i) {
+            obj *next = q->free_list_link;
+            deallocate(q, n);
+            q = next;
+        }
+        return;
+    }
+
+    //链按所属线程切成若干段：属于本线程的段接到线程缓存的链首，过长时一次归还多余的区块；
+    //属于其他线程的段整段压入其远程释放队列。相邻的区块通常属于同一线程，每段只需一次原子操作
+    thread_cache& cache = local_cache();
+    size_t index = FREELIST_INDEX(n);
+    cache.counts.frees[index] += count;
+    cache.counts.requested_bytes -= n * count;
+    size_t local = 0;
+    while (count != 0) {
+        remote_queue *owner = CHUNK_OF(q)->owner;
+        obj *last = q;
+        size_t run = 1;
+        while (run < count && CHUNK_OF(last->free_list_link)->owner == owner) {
+            last = last->free_list_link;
+            ++run;
+        }
+        obj *next = run < count ? last->free_list_link : 0;
+        if (owner != cache.queue && owner != 0) {
+            push_remote(owner, index, q, last, run);
+        } else {
+            last->free_list_link = cache.free_list[index];
+            cache.free_list[index] = q;
+            local += run;
+        }
+        q = next;
+        count -= run;
+    }
+    if (local == 0) return;
+    size_t length = cache.length[index] += local;
+    if (length > 2 * BATCH_COUNT(index)) {
+        std::lock_guard<std::mutex> lock(depot_mutex);
+        release_to_depot(cache, index, length - BATCH_COUNT(index));
+    }
+}
+
+size_t alloc::trim() {
+    //线程缓存的构造函数会加锁，须在加锁之前取得
+    thread_cache *cache = cache_destroyed ? 0 : &local_cache();
+    if (cache) flush_remote(*cache);
+    std::lock_guard<std::mutex> lock(depot_mutex);
+    if (cache) {
+        for (int i = 0; i < NFREELISTS; ++i) {
+            drain_remote(*cache, i);
+            release_to_depot(*cache, i, cache->length[i].get());
+        }
+    }
+    return trim_locked();
+}
+
+void alloc::set_trim_threshold(size_t bytes) {
+    std::lock_guard<std::mutex> lock(depot_mutex);
+    trim_threshold = bytes;
+    trim_trigger = depot_free_bytes + bytes;
+}
+
+void alloc::set_huge_page_arena(bool enable) {
+    std::lock_guard<std::mutex> lock(depot_mutex);
+    huge_page_arena = enable;
+}
+
+void alloc::get_stats(stats& s) {
+    std::lock_guard<std::mutex> lock(depot_mutex);
+    s.requested_bytes = retired_counts.requested_bytes.get();
+    s.large_allocs = retired_counts.large_allocs.get();
+    s.large_frees = retired_counts.large_frees.get();
+    s.large_bytes = retired_counts.large_bytes.get();
+    for (thread_cache *cache = cache_list; cache; cache = cache->next) {
+        s.requested_bytes += cache->counts.requested_bytes.get();
+        s.large_allocs += cache->counts.large_allocs.get();
+        s.large_frees += cache->counts.large_frees.get();
+        s.large_bytes += cache->counts.large_bytes.get();
+    }
+
+    s.live_bytes = 0;
+    s.free_bytes = 0;
+    for (size_t i = 0; i < NFREELISTS; ++i) {
+        class_stats& cs = s.size_class[i];
+        cs.block_size = CLASS_SIZE(i);
+        cs.allocs = retired_counts.allocs[i].get();
+        cs.frees = retired_counts.frees[i].get();
+        cs.cached_free = 0;
+        cs.remote_free = 0;
+        for (thread_cache *cache = cache_list; cache; cache = cache->next) {
+            cs.allocs += cache->counts.allocs[i].get();
+            cs.frees += cache->counts.frees[i].get();
+            cs.cached_free += cache->length[i].get();
+            cs.remote_free += cache->queue->slot[i].count.load(std::memory_order_relaxed);
+            if (cache->pending_index.get() == i) cs.remote_free += cache->pending_length.get();
+        }
+        for (remote_queue *queue = orphan_queues; queue; queue = queue->next_orphan) {
+            cs.remote_free += queue->slot[i].count.load(std::memory_order_relaxed);
+        }
+        cs.live = cs.allocs - cs.frees;
+        cs.depot_free = 0;
+        for (obj *p = free_list[i]; p; p = p->free_list_link) {
+            ++cs.depot_free;
+        }
+        s.live_bytes += cs.live * cs.block_size;
+        s.free_bytes += (cs.depot_free + cs.cached_free + cs.remote_free) * cs.block_size;
+    }
+
+    s.chunk_count = 0;
+    s.arena_chunk_count = 0;
+    for (chunk_header *chunk = chunk_list; chunk; chunk = chunk->next) {
+        ++s.chunk_count;
+        if (chunk->from_arena) ++s.arena_chunk_count;
+    }
+    s.heap_size = heap_size;
+}
+
+void alloc::print_stats(std::ostream& os) {
+    stats s;
+    get_stats(s);
+    os << "chunks: " << s.chunk_count << " (arena " << s.arena_chunk_count << ")"
+       << ", heap size: " << s.heap_size << " bytes" << std::endl;
+    os << "requested: " << s.requested_bytes << " bytes, live: " << s.live_bytes
+       << " bytes, free: " << s.free_bytes << " bytes" << std::endl;
+    os << "malloc: " << s.large_allocs << " allocs, " << s.large_frees
+       << " frees, " << s.large_bytes << " bytes live" << std::endl;
+    os << std::setw(8) << "size" << std::setw(12) << "allocs" << std::setw(12) << "frees"
+       << std::setw(10) << "live" << std::setw(10) << "cached" << std::setw(10) << "depot"
+       << std::setw(10) << "remote" << std::endl;
+    for (size_t i = 0; i < NSIZECLASSES; ++i) {
+        const class_stats& cs = s.size_class[i];
+        if (cs.allocs == 0 && cs.depot_free == 0 && cs.cached_free == 0
+            && cs.remote_free == 0) continue;
+        os << std::setw(8) << cs.block_size << std::setw(12) << cs.allocs
+           << std::setw(12) << cs.frees << std::setw(10) << cs.live
+           << std::setw(10) << cs.cached_free << std::setw(10) << cs.depot_free
+           << std::setw(10) << cs.remote_free << std::endl;
+    }
+}
+
+void alloc::set_sample_interval(size_t bytes) {
+    sample_interval.store(bytes, std::memory_order_relaxed);
+}
+
+//采样间隔取均值为sample_interval的指数分布，使每个字节被采样的概率相同
+//不可内联，否则调用栈中需跳过的层数会改变
+__attribute__((noinline))
+void alloc::record_sample(thread_cache& cache, void *p, size_t n) {
+    size_t interval = sample_interval.load(std::memory_order_relaxed);
+    //xorshift64*，取高53位作为(0, 1]中的均匀分布
+    unsigned long long x = cache.rng_state;
+    x ^= x >> 12;
+    x ^= x << 25;
+    x ^= x >> 27;
+    cache.rng_state = x;
+    double u = ((x * 2685821657736338717ULL) >> 11) * (1.0 / 9007199254740992.0);
+    cache.bytes_until_sample = static_cast<size_t>(-std::log(1.0 - u) * interval) + 1;
+
+    heap_sample sample;
+    sample.size = n;
+    sample.interval = interval;
+    //跳过record_sample与allocate两层
+    void *stack[heap_sample::MAX_STACK_DEPTH + 2];
+    int depth = backtrace(stack, heap_sample::MAX_STACK_DEPTH + 2) - 2;
+    sample.depth = depth > 0 ? depth : 0;
+    for (int i = 0; i < sample.depth; ++i) {
+        sample.stack[i] = stack[i + 2];
+    }
+
+    std::lock_guard<std::mutex> lock(sample_mutex);
+    if (!sample_map()->insert(std::make_pair(p, sample)).second) return;
+    live_samples.fetch_add(1, std::memory_order_relaxed);
+    if (n > MAX_POOLED_BYTES) {
+        live_large_samples.fetch_add(1, std::memory_order_relaxed);
+    } else {
+        CHUNK_OF(p)->sampled.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+//池中的区块先检查所在chunk的采样数，绝大多数释放无需加锁查找
+void alloc::forget_sample(void *p, size_t n) {
+    if (n > MAX_POOLED_BYTES) {
+        if (live_large_samples.load(std::memory_order_relaxed) == 0) return;
+    } else {
+        if (CHUNK_OF(p)->sampled.load(std::memory_order_relaxed) == 0) return;
+    }
+
+    std::lock_guard<std::mutex> lock(sample_mutex);
+    if (sample_map()->erase(p) == 0) return;
+    live_samples.fetch_sub(1, std::memory_order_relaxed);
+    if (n > MAX_POOLED_BYTES) {
+        live_large_samples.fetch_sub(1, std::memory_order_relaxed);
+    } else {
+        CHUNK_OF(p)->sampled.fetch_sub(1, std::memory_order_relaxed);
+    }
+}
+
+//按调用栈汇总：first为采样数，second为请求字节数之和
+typedef std::map<std::vector<void *>, std::pair<size_t, size_t> > stack_table;
+
+//legacy pprof的heap profile格式，由pprof按heap_v2/interval自行还原采样前的数值
+//方括号中为累计分配，此处不做记录，写作0
+void alloc::write_heap_profile(std::ostream& os) {
+    stack_table table;
+    size_t total_count = 0, total_bytes = 0;
+    {
+        std::lock_guard<std::mutex> lock(sample_mutex);
+        for (const auto& entry : *sample_map()) {
+            const heap_sample& sample = entry.second;
+            std::pair<size_t, size_t>& slot =
+                table[std::vector<void *>(sample.stack, sample.stack + sample.depth)];
+            ++slot.first;
+            slot.second += sample.size;
+            ++total_count;
+            total_bytes += sample.size;
+        }
+    }
+
+    os << "heap profile: " << total_count << ": " << total_bytes
+       << " [0: 0] @ heap_v2/" << sample_interval.load(std::memory_order_relaxed)
+       << std::endl;
+    for (const auto& entry : table) {
+        os << entry.second.first << ": " << entry.second.second << " [0: 0] @";
+        for (void *pc : entry.first) {
+            os << " " << pc;
+        }
+        os << std::endl;
+    }
+    //pprof据此将地址映射到可执行文件与共享库
+    os << std::endl << "MAPPED_LIBRARIES:" << std::endl;
+    std::ifstream maps("/proc/self/maps");
+    if (maps) os << maps.rdbuf();
+}
+
+//采样概率为1 - exp(-size / interval)，每个采样代表size / (1 - exp(-size / interval))字节
+void alloc::print_heap_profile(std::ostream& os) {
+    typedef std::pair<double, std::vector<void *> > weighted_stack;
+    std::map<std::vector<void *>, std::pair<double, double> > table;
+    size_t count = 0;
+    double total = 0;
+    {
+        std::lock_guard<std::mutex> lock(sample_mutex);
+        for (const auto& entry : *sample_map()) {
+            const heap_sample& sample = entry.second;
+            double scale = 1 / (1 - std::exp(-static_cast<double>(sample.size) / sample.interval));
+            std::pair<double, double>& slot =
+                table[std::vector<void *>(sample.stack, sample.stack + sample.depth)];
+            slot.first += scale;
+            slot.second += scale * sample.size;
+            ++count;
+            total += scale * sample.size;
+        }
+    }
+    std::vector<weighted_stack> order;
+    for (const auto& entry : table) {
+        order.push_back(weighted_stack(entry.second.second, entry.first));
+    }
+    std::sort(order.begin(), order.end(),
+              [](const weighted_stack& a, const weighted_stack& b) { return a.first > b.first; });
+
+    os << "heap profile: " << count << " samples, ~" << static_cast<size_t>(total)
+       << " bytes live" << std::endl;
+    for (const weighted_stack& entry : order) {
+        const std::pair<double, double>& slot = table[entry.second];
+        os << std::endl << "~" << static_cast<size_t>(slot.second) << " bytes in ~"
+           << static_cast<size_t>(slot.first + 0.5) << " objects ("
+           << std::fixed << std::setprecision(1) << 100 * slot.second / total
+           << "%) allocated at:" << std::endl;
+        os.unsetf(std::ios::floatfield);
+        const std::vector<void *>& stack = entry.second;
+        char **symbols = backtrace_symbols(stack.data(), static_cast<int>(stack.size()));
+        for (size_t i = 0; i < stack.size(); ++i) {
+            os << "    " << (symbols ? symbols[i] : "?") << std::endl;
+        }
+        free(symbols);
+    }
+}
+
+//Treiber栈的压入：区块的链接在compare_exchange之前写好，以release发布给取走它的线程
+//count先于压栈增加，取走的线程随后减去，因此统计值不会小于栈中实际的区块数
+void alloc::push_remote(remote_queue *owner, size_t index, obj *first, obj *last, size_t count) {
+    remote_slot& slot = owner->slot[index];
+    slot.count.fetch_add(count, std::memory_order_relaxed);
+    obj *head = slot.head.load(std::memory_order_relaxed);
+    do {
+        last->free_list_link = head;
+    } while (!slot.head.compare_exchange_weak(head, first, std::memory_order_release,
+                                              std::memory_order_relaxed));
+}
+
+//生产者/消费者模式中连续的释放大多属于同一线程、同一级别，攒成一串可大幅减少原子操作
+void alloc::free_remote(thread_cache& cache, remote_queue *owner, size_t index, obj *p) {
+    if (cache.pending_length.get() != 0
+        && (cache.pending_owner != owner || cache.pending_index.get() != index)) {
+        flush_remote(cache);
+    }
+    if (cache.pending_length.get() == 0) {
+        cache.pending_last = p;
+        cache.pending_owner = owner;
+        cache.pending_index.set(index);
+    }
+    p->free_list_link = cache.pending_first;
+    cache.pending_first = p;
+    if (++cache.pending_length >= BATCH_COUNT(index)) {
+        flush_remote(cache);
+    }
+}
+
+void alloc::flush_remote(thread_cache& cache) {
+    size_t count = cache.pending_length.get();
+    if (count == 0) return;
+    push_remote(cache.pending_owner, cache.pending_index.get(),
+                cache.pending_first, cache.pending_last, count);
+    cache.pending_first = cache.pending_last = 0;
+    cache.pending_length -= count;
+}
+
+//只有整栈取走，没有单个弹出，因此不存在ABA问题，多个线程同时取走也是安全的
+alloc::obj *alloc::take_remote(remote_queue *queue, size_t index, obj *&last, size_t& count) {
+    remote_slot& slot = queue->slot[index];
+    if (slot.head.load(std::memory_order_relaxed) == 0) return 0;
+    obj *first = slot.head.exchange(0, std::memory_order_acquire);
+    if (first == 0) return 0;
+    last = first;
+    count = 1;
+    while (last->free_list_link) {
+        last = last->free_list_link;
+        ++count;
+    }
+    slot.count.fetch_sub(count, std::memory_order_relaxed);
+    return first;
+}
+
+//取回的区块接在线程缓存之后，不检查长度，多余的区块在下一次释放时归还中心内存池
+size_t alloc::drain_remote(thread_cache& cache, size_t index) {
+    obj *last;
+    size_t count;
+    obj *first = take_remote(cache.queue, index, last, count);
+    if (first == 0) return 0;
+    last->free_list_link = cache.free_list[index];
+    cache.free_list[index] = first;
+    cache.length[index] += count;
+    return count;
+}
+
+//无主队列中可能留有区块，由接管的线程在缓存为空时取回
+//队列以malloc分配并按缓存行对齐，之后一直保留，其他线程随时可以安全地压入
+alloc::remote_queue *alloc::adopt_queue() {
+    if (orphan_queues) {
+        remote_queue *queue = orphan_queues;
+        orphan_queues = queue->next_orphan;
+        return queue;
+    }
+    void *raw = malloc(sizeof(remote_queue) + CACHE_LINE_SIZE);
+    if (!raw) throw std::bad_alloc();
+    void *aligned = reinterpret_cast<void *>(
+        (reinterpret_cast<size_t>(raw) + CACHE_LINE_SIZE - 1) & ~(static_cast<size_t>(CACHE_LINE_SIZE) - 1));
+    return new (aligned) remote_queue();
+}
+
+//从中心内存池取出至多BATCH_COUNT个大小为n的区块
+//第一个返回给客端，其余放入线程缓存，假设n已经上调至区块大小
+void *alloc::fetch_from_depot(thread_cache& cache, size_t n) {
+    size_t index = FREELIST_INDEX(n);
+    obj **my_free_list = free_list + index;
+    void *result;
+
+    if (*my_free_list == 0) {
+        result = refill(n, cache.pool); //中心内存池也为空，从本线程的chunk中切出新区块
+    } else {
+        result = *my_free_list;
+        *my_free_list = (*my_free_list)->free_list_link;
+        depot_free_bytes -= n;
+    }
+
+    //将中心free-list的前若干个区块整段摘下，挂到线程缓存上
+    obj *first = *my_free_list;
+    if (first == 0) return result;
+    obj *last = first;
+    size_t count = 1;
+    while (count < BATCH_COUNT(index) - 1 && last->free_list_link != 0) {
+        last = last->free_list_link;
+        ++count;
+    }
+    *my_free_list = last->free_list_link;
+    last->free_list_link = cache.free_list[index];
+    cache.free_list[index] = first;
+    cache.length[index] += count;
+    depot_free_bytes -= count * n;
+    return result;
+}
+
+//将线程缓存第index个free-list的前count个区块整段归还中心内存池
+//中心内存池的空闲字节超过阈值时顺便trim
+void alloc::release_to_depot(thread_cache& cache, size_t index, size_t count) {
+    if (count == 0) return;
+    obj *first = cache.free_list[index];
+    obj *last = first;
+    for (size_t i = 1; i < count; ++i) {
+        last = last->free_list_link;
+    }
+    cache.free_list[index] = last->free_list_link;
+    cache.length[index] -= count;
+    last->free_list_link = free_list[index];
+    free_list[index] = first;
+    depot_free_bytes += count * CLASS_SIZE(index);
+    if (trim_threshold != 0 && depot_free_bytes >= trim_trigger) {
+        trim_locked();
+    }
+}
+
+//先整段取走中心free-list上的区块，仍不足时反复调用chunk_alloc切分
+//chunk_alloc抛出bad_alloc时，已补充的区块留在线程缓存中
+void alloc::fill_cache_locked(thread_cache& cache, size_t index, size_t count) {
+    const size_t n = CLASS_SIZE(index);
+    obj **my_free_list = free_list + index;
+    if (*my_free_list != 0) {
+        obj *first = *my_free_list;
+        obj *last = first;
+        size_t taken = 1;
+        while (taken < count && last->free_list_link != 0) {
+            last = last->free_list_link;
+            ++taken;
+        }
+        *my_free_list = last->free_list_link;
+        last->free_list_link = cache.free_list[index];
+        cache.free_list[index] = first;
+        cache.length[index] += taken;
+        depot_free_bytes -= taken * n;
+        count -= taken;
+    }
+
+    while (count > 0) {
+        int nobjs = count > INT_MAX ? INT_MAX : static_cast<int>(count);
+        char *chunk = chunk_alloc(n, nobjs, cache.pool);
+        //按地址顺序串联，使随后的节点在内存中相邻
+        obj *first = reinterpret_cast<obj *>(chunk);
+        obj *last = first;
+        for (int i = 1; i < nobjs; ++i) {
+            obj *next = reinterpret_cast<obj *>(chunk + i * n);
+            last->free_list_link = next;
+            last = next;
+        }
+        last->free_list_link = cache.free_list[index];
+        cache.free_list[index] = first;
+        cache.length[index] += nobjs;
+        count -= nobjs;
+    }
 }
 
 //返回一个大小为n的对象，并且有时候会为适当的free-list增加节点
-//假设n已经上调至8的倍数
-void* alloc::refill(size_t n) {
-    int nobjs = 20;
+//假设n已经上调至区块大小，调用者需持有depot_mutex
+void* alloc::refill(size_t n, pool_region& region) {
+    int nobjs = static_cast<int>(BATCH_COUNT(FREELIST_INDEX(n)));
     //调用chunk_alloc()，尝试取得nobjs个区块最为free-list的新节点
     //注意nobjs是传引用
-    char *chunk = chunk_alloc(n, nobjs); //从内存池取
+    char *chunk = chunk_alloc(n, nobjs, region); //从内存池取
     obj **my_free_list;
     obj *result;
     obj *current_obj, *next_obj;
@@ -69,72 +840,210 @@ void* alloc::refill(size_t n) {
     *my_free_list = next_obj = reinterpret_cast<obj *>(chunk + n); //导引free-list指向新配置的空间
     for (int i = 1; ; ++i) {
         current_obj = next_obj;
-        next_obj = reinterpret_cast<obj *>(reinterpret_cast<char *>(next_obj + n));
-        if (i = nobjs - 1) {
+        next_obj = reinterpret_cast<obj *>(reinterpret_cast<char *>(next_obj) + n);
+        if (i == nobjs - 1) {
             current_obj->free_list_link = 0;
             break;
         } else {
             current_obj->free_list_link = next_obj;
         }
     }
+    depot_free_bytes += (nobjs - 1) * n;
     return result;
 }
 
-//假设size已经适当上调至8的倍数
-//主要nobjs是传引用
-char *alloc::chunk_alloc(size_t size, int& nobjs) { //内存池
+//残余空间总是8的倍数，每次取不超过残余大小的最大级别，调用者需持有depot_mutex
+//线程退出时整个未切分的区域都作为残余，超过最大级别的部分按最大级别拆分
+void alloc::reclaim_leftover(char *p, size_t bytes) {
+    while (bytes >= ALIGN) {
+        size_t index = bytes > MAX_POOLED_BYTES ? NFREELISTS - 1 : FREELIST_INDEX(bytes);
+        if (CLASS_SIZE(index) > bytes) --index; //中型级别不连续，向下取一级
+        obj *q = reinterpret_cast<obj *>(p);
+        q->free_list_link = free_list[index];
+        free_list[index] = q;
+        p += CLASS_SIZE(index);
+        bytes -= CLASS_SIZE(index);
+        depot_free_bytes += CLASS_SIZE(index);
+    }
+}
+
+//假设size已经适当上调至区块大小
+//主要nobjs是传引用，新的chunk属于region.owner，调用者需持有depot_mutex
+char *alloc::chunk_alloc(size_t size, int& nobjs, pool_region& region) { //内存池
     char *result;
     size_t total_bytes = size * nobjs;
-    size_t bytes_left = end_free - start_free; //内存池剩余空间
+    size_t bytes_left = region.end_free - region.start_free; //内存池剩余空间
 
     if (bytes_left >= total_bytes) {
         //内存池剩余空间完全满足需求量
-        result = start_free;
-        start_free += total_bytes;
+        result = region.start_free;
+        region.start_free += total_bytes;
         return result;
     } else if (bytes_left >= size) {
         //剩余空间不完全满足需求量，但足够供应一个以上的区块
         nobjs = bytes_left / size;
         total_bytes = size * nobjs;
-        result = start_free;
-        start_free += total_bytes;
+        result = region.start_free;
+        region.start_free += total_bytes;
         return result;
     } else {
         //内存池剩余空间连一个区块的大小都无法满足
-        size_t bytes_to_get = 2 * total_bytes + ROUND_UP(heap_size >> 4);
         //以下试着让内存池中的参与碎片还有利用价值
-        if (bytes_left > 0) {
-            obj **my_free_list = free_list + FREELIST_INDEX(bytes_left);
-            (reinterpret_cast<obj *>(start_free))->free_list_link = *my_free_list;
-            *my_free_list = reinterpret_cast<obj *>(start_free);
-        }
+        reclaim_leftover(region.start_free, bytes_left);
 
-        //配置heap空间，用来补充内存池
-        start_free = static_cast<char *>(malloc(bytes_to_get));
-        if (!start_free) {
-            //heap空间不足，malloc失败
+        //向系统申请新的chunk，用来补充内存池
+        region.start_free = chunk_acquire(region.owner);
+        if (!region.start_free) {
+            //系统内存不足，申请失败
             obj **my_free_list, *p;
-            for (int i = size; i <= MAX_BYTES; i += ALIGN) {
-                my_free_list = free_list + FREELIST_INDEX(i);
+            for (size_t i = FREELIST_INDEX(size); i < NFREELISTS; ++i) {
+                my_free_list = free_list + i;
                 p = *my_free_list;
                 if (p != 0) {
                     //调整free-list以释放未使用区块
                     *my_free_list = p->free_list_link;
-                    start_free = reinterpret_cast<char *>(p);
-                    end_free = start_free + i;
+                    depot_free_bytes -= CLASS_SIZE(i);
+                    region.start_free = reinterpret_cast<char *>(p);
+                    region.end_free = region.start_free + CLASS_SIZE(i);
                     //递归调用自己，调整nobjs
-                    return (chunk_alloc(size, nobjs));
+                    return (chunk_alloc(size, nobjs, region));
                 }
             }
-            end_free = 0; //没有可用内存了
-            //调用第一级配置器，利用out-of-memory机制
-            start_free = static_cast<char *>(malloc(bytes_to_get));
+            region.end_free = 0; //没有可用内存了
+            throw std::bad_alloc();
         }
-        heap_size += bytes_to_get;
-        end_free = start_free + bytes_to_get;
+        region.end_free = region.start_free + (CHUNK_SIZE - CHUNK_HEADER_SIZE);
         //递归调用自己，调整nobjs
-        return chunk_alloc(size, nobjs);
+        return chunk_alloc(size, nobjs, region);
+    }
+}
+
+//申请一个按CHUNK_SIZE对齐的chunk，开启大页arena时优先从arena切分
+//返回chunk头部之后的可用空间，调用者需持有depot_mutex
+char *alloc::chunk_acquire(remote_queue *owner) {
+    char *aligned = 0;
+    bool from_arena = false;
+    if (huge_page_arena) {
+        aligned = arena_chunk();
+        from_arena = aligned != 0;
+    }
+    if (!aligned) {
+        aligned = map_aligned(CHUNK_SIZE, CHUNK_SIZE);
+        if (!aligned) return 0;
+    }
+
+    chunk_header *chunk = reinterpret_cast<chunk_header *>(aligned);
+    chunk->prev = 0;
+    chunk->next = chunk_list;
+    chunk->free_bytes = 0;
+    chunk->from_arena = from_arena;
+    chunk->sampled.store(0, std::memory_order_relaxed);
+    chunk->owner = owner;
+    if (chunk_list) chunk_list->prev = chunk;
+    chunk_list = chunk;
+    heap_size += CHUNK_SIZE;
+    return aligned + CHUNK_HEADER_SIZE;
+}
+
+//arena区域按大页对齐，并以MADV_HUGEPAGE建议内核使用透明大页
+//内核不支持透明大页时madvise失败，区域仍按普通页使用，调用者需持有depot_mutex
+char *alloc::arena_chunk() {
+    if (arena_cur == arena_end) {
+        char *region = map_aligned(ARENA_SIZE, HUGE_PAGE_SIZE);
+        if (!region) return 0;
+#ifdef MADV_HUGEPAGE
+        madvise(region, ARENA_SIZE, MADV_HUGEPAGE);
+#endif
+        arena_cur = region;
+        arena_end = region + ARENA_SIZE;
+    }
+    char *result = arena_cur;
+    arena_cur += CHUNK_SIZE;
+    return result;
+}
+
+//调用者需持有depot_mutex
+void alloc::chunk_release(chunk_header *chunk) {
+    if (chunk->prev) chunk->prev->next = chunk->next;
+    else chunk_list = chunk->next;
+    if (chunk->next) chunk->next->prev = chunk->prev;
+    heap_size -= CHUNK_SIZE;
+    munmap(chunk, CHUNK_SIZE);
+}
+
+//统计每个chunk在中心内存池中的空闲字节，空闲字节等于可用空间的chunk即完全空闲：
+//先将其区块从free-lists中摘除，再归还系统
+//线程缓存中的区块不在统计之内，持有这些区块的chunk不会被释放
+//arena中的chunk预先记入一个不可能达到的空闲值，从而跳过
+size_t alloc::trim_locked() {
+    const size_t usable = CHUNK_SIZE - CHUNK_HEADER_SIZE;
+    //无主队列中的区块不会再被取走，先并入中心内存池
+    for (remote_queue *queue = orphan_queues; queue; queue = queue->next_orphan) {
+        for (size_t i = 0; i < NFREELISTS; ++i) {
+            obj *last;
+            size_t count;
+            obj *first = take_remote(queue, i, last, count);
+            if (first == 0) continue;
+            last->free_list_link = free_list[i];
+            free_list[i] = first;
+            depot_free_bytes += count * CLASS_SIZE(i);
+        }
+    }
+
+    for (chunk_header *chunk = chunk_list; chunk; chunk = chunk->next) {
+        chunk->free_bytes = chunk->from_arena ? CHUNK_SIZE : 0;
+    }
+    //各线程尚未切分的区域同样计入空闲字节
+    if (pool.end_free != pool.start_free) {
+        CHUNK_OF(pool.start_free)->free_bytes += pool.end_free - pool.start_free;
+    }
+    for (thread_cache *cache = cache_list; cache; cache = cache->next) {
+        pool_region& region = cache->pool;
+        if (region.end_free != region.start_free) {
+            CHUNK_OF(region.start_free)->free_bytes += region.end_free - region.start_free;
+        }
+    }
+    for (size_t i = 0; i < NFREELISTS; ++i) {
+        for (obj *p = free_list[i]; p; p = p->free_list_link) {
+            CHUNK_OF(p)->free_bytes += CLASS_SIZE(i);
+        }
+    }
+
+    //摘除属于完全空闲chunk的区块
+    for (size_t i = 0; i < NFREELISTS; ++i) {
+        obj **link = free_list + i;
+        while (*link) {
+            if (CHUNK_OF(*link)->free_bytes == usable) {
+                *link = (*link)->free_list_link;
+                depot_free_bytes -= CLASS_SIZE(i);
+            } else {
+                link = &(*link)->free_list_link;
+            }
+        }
+    }
+    if (pool.end_free != pool.start_free && CHUNK_OF(pool.start_free)->free_bytes == usable) {
+        pool.start_free = pool.end_free = 0;
+    }
+    for (thread_cache *cache = cache_list; cache; cache = cache->next) {
+        pool_region& region = cache->pool;
+        if (region.end_free != region.start_free
+            && CHUNK_OF(region.start_free)->free_bytes == usable) {
+            region.start_free = region.end_free = 0;
+        }
+    }
+
+    size_t released = 0;
+    chunk_header *chunk = chunk_list;
+    while (chunk) {
+        chunk_header *next = chunk->next;
+        if (chunk->free_bytes == usable) {
+            chunk_release(chunk);
+            released += CHUNK_SIZE;
+        }
+        chunk = next;
     }
+    trim_trigger = depot_free_bytes + trim_threshold;
+    return released;
 }
 
 } //namespace mystl
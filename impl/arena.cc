@@ -0,0 +1,53 @@
+#include "../arena.h"
+
+#include <new> //for bad_alloc
+
+namespace mystl {
+
+monotonic_arena::~monotonic_arena() {
+    while (blocks_) {
+        block_header *next = blocks_->next;
+        free(blocks_);
+        blocks_ = next;
+    }
+}
+
+//新内存块的大小每次翻倍，直至MAX_BLOCK_SIZE；放不下请求的区块时按请求申请
+//当前内存块剩余过半时，超大请求单独成块挂在表头之后，当前内存块继续使用
+void *monotonic_arena::allocate_slow(size_t bytes) {
+    size_t size = next_block_size_;
+    if (size < bytes + BLOCK_HEADER_SIZE) size = bytes + BLOCK_HEADER_SIZE;
+    block_header *block = static_cast<block_header *>(malloc(size));
+    if (!block) throw std::bad_alloc();
+    block->size = size;
+    char *data = reinterpret_cast<char *>(block) + BLOCK_HEADER_SIZE;
+
+    if (blocks_ && size != next_block_size_
+        && static_cast<size_t>(end_ - cur_) * 4 > next_block_size_) {
+        block->next = blocks_->next;
+        blocks_->next = block;
+        return data;
+    }
+    block->next = blocks_;
+    blocks_ = block;
+    cur_ = data + bytes;
+    end_ = reinterpret_cast<char *>(block) + size;
+    if (next_block_size_ < MAX_BLOCK_SIZE) next_block_size_ *= 2;
+    return data;
+}
+
+void monotonic_arena::release() {
+    bytes_allocated_ = 0;
+    if (!blocks_) return;
+    block_header *block = blocks_->next;
+    while (block) {
+        block_header *next = block->next;
+        free(block);
+        block = next;
+    }
+    blocks_->next = 0;
+    cur_ = reinterpret_cast<char *>(blocks_) + BLOCK_HEADER_SIZE;
+    end_ = reinterpret_cast<char *>(blocks_) + blocks_->size;
+}
+
+}//namespace mystl
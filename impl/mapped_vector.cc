@@ -0,0 +1,96 @@
+#include "../mapped_vector.h"
+
+#include <cerrno> //for errno
+#include <cstring> //for strerror
+#include <string> //for string
+
+#include <fcntl.h> //for open
+#include <sys/mman.h> //for mmap, munmap, mremap, msync
+#include <sys/stat.h> //for fstat
+#include <unistd.h> //for close, ftruncate
+
+namespace mystl {
+
+static void throw_errno(const char *what) {
+    throw std::runtime_error(std::string(what) + ": " + std::strerror(errno));
+}
+
+//空文件不映射，data()为空
+void mapped_file::open(const char *path, open_mode mode) {
+    close();
+    bool writable = mode == read_write;
+    int fd = ::open(path, writable ? O_RDWR | O_CREAT : O_RDONLY, 0644);
+    if (fd == -1) throw_errno("mapped_file: open");
+    struct stat st;
+    if (::fstat(fd, &st) == -1) {
+        ::close(fd);
+        throw_errno("mapped_file: fstat");
+    }
+    size_t length = static_cast<size_t>(st.st_size);
+    char *data = 0;
+    if (length != 0) {
+        void *p = ::mmap(0, length, writable ? PROT_READ | PROT_WRITE : PROT_READ,
+                         MAP_SHARED, fd, 0);
+        if (p == MAP_FAILED) {
+            ::close(fd);
+            throw_errno("mapped_file: mmap");
+        }
+        data = static_cast<char *>(p);
+    }
+    fd_ = fd;
+    data_ = data;
+    length_ = length;
+    writable_ = writable;
+}
+
+void mapped_file::close() {
+    if (fd_ == -1) return;
+    if (data_) ::munmap(data_, length_);
+    ::close(fd_);
+    fd_ = -1;
+    data_ = 0;
+    length_ = 0;
+    writable_ = false;
+}
+
+//Linux上经mremap扩展映射，内核可直接移动页表而不必复制；其他系统解除映射后重新映射
+void mapped_file::resize(size_t length) {
+    if (!writable_) throw std::logic_error("mapped_file is read-only");
+    if (length == length_) return;
+    if (::ftruncate(fd_, static_cast<off_t>(length)) == -1) throw_errno("mapped_file: ftruncate");
+    void *p;
+    if (length == 0) {
+        ::munmap(data_, length_);
+        p = 0;
+    } else if (data_ == 0) {
+        p = ::mmap(0, length, PROT_READ | PROT_WRITE, MAP_SHARED, fd_, 0);
+    } else {
+#ifdef __linux__
+        p = ::mremap(data_, length_, length, MREMAP_MAYMOVE);
+#else
+        ::munmap(data_, length_);
+        p = ::mmap(0, length, PROT_READ | PROT_WRITE, MAP_SHARED, fd_, 0);
+#endif
+    }
+    if (p == MAP_FAILED) {
+        //映射失败时文件已调整为新的长度，恢复原长度，原映射（mremap失败时）仍然有效
+        int saved = errno;
+        int ignored = ::ftruncate(fd_, static_cast<off_t>(length_));
+        (void)ignored;
+        errno = saved;
+#ifndef __linux__
+        data_ = 0;
+        close();
+#endif
+        throw_errno("mapped_file: mmap");
+    }
+    data_ = static_cast<char *>(p);
+    length_ = length;
+}
+
+void mapped_file::sync() {
+    if (data_ && writable_ && ::msync(data_, length_, MS_SYNC) == -1)
+        throw_errno("mapped_file: msync");
+}
+
+} //namespace mystl
@@ -0,0 +1,47 @@
+#include "../memory_resource.h"
+#include "../alloc.h"
+
+#include <atomic> //for atomic
+
+namespace mystl {
+
+//以alloc内存池为来源，所有实例共用同一个内存池，因此彼此相等
+class pool_memory_resource : public memory_resource {
+protected:
+    virtual void *do_allocate(size_t bytes) {
+        return alloc::allocate(bytes);
+    }
+    virtual void do_deallocate(void *p, size_t bytes) {
+        alloc::deallocate(p, bytes);
+    }
+    virtual bool do_is_equal(const memory_resource& other) const {
+        return dynamic_cast<const pool_memory_resource *>(&other) != 0;
+    }
+};
+
+//有意不析构，静态对象析构期间仍可使用
+memory_resource *pool_resource() {
+    static pool_memory_resource *instance = new pool_memory_resource;
+    return instance;
+}
+
+static std::atomic<memory_resource *> default_resource(0);
+
+memory_resource *get_default_resource() {
+    memory_resource *r = default_resource.load(std::memory_order_acquire);
+    return r ? r : pool_resource();
+}
+
+memory_resource *set_default_resource(memory_resource *r) {
+    memory_resource *old = default_resource.exchange(r, std::memory_order_acq_rel);
+    return old ? old : pool_resource();
+}
+
+void *monotonic_resource::do_allocate(size_t bytes) {
+    return arena_.allocate(bytes);
+}
+
+void monotonic_resource::do_deallocate(void *, size_t) {
+}
+
+}//namespace mystl
@@ -0,0 +1,86 @@
+#include "../parallel.h"
+
+namespace mystl {
+
+static std::atomic<size_t> parallel_threshold_bytes(0);
+
+void set_parallel_threshold(size_t bytes) {
+    parallel_threshold_bytes.store(bytes, std::memory_order_relaxed);
+}
+
+size_t parallel_threshold() {
+    return parallel_threshold_bytes.load(std::memory_order_relaxed);
+}
+
+//函数内的静态对象在第一次调用时线程安全地构造，程序结束时析构并回收工作线程
+thread_pool& thread_pool::instance() {
+    static thread_pool pool;
+    return pool;
+}
+
+thread_pool::thread_pool()
+    : workers_(0), threads_(0), busy_(false), task_(0), count_(0), next_(0),
+      pending_(0), generation_(0), stop_(false) {
+    unsigned int hardware = std::thread::hardware_concurrency();
+    workers_ = hardware > 1 ? hardware - 1 : 0;
+    if (workers_ == 0) return;
+    threads_ = new std::thread[workers_];
+    for (size_t i = 0; i != workers_; ++i)
+        threads_[i] = std::thread(&thread_pool::worker_loop, this);
+}
+
+thread_pool::~thread_pool() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stop_ = true;
+    }
+    start_cv_.notify_all();
+    for (size_t i = 0; i != workers_; ++i) threads_[i].join();
+    delete[] threads_;
+}
+
+void thread_pool::run(size_t count, const std::function<void(size_t)>& task) {
+    bool expected = false;
+    if (workers_ == 0 || count < 2 || !busy_.compare_exchange_strong(expected, true)) {
+        for (size_t i = 0; i != count; ++i) task(i);
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        task_ = &task;
+        count_ = count;
+        next_.store(0);
+        pending_ = workers_;
+        ++generation_;
+    }
+    start_cv_.notify_all();
+    work();
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        done_cv_.wait(lock, [this] { return pending_ == 0; });
+        task_ = 0;
+    }
+    busy_.store(false);
+}
+
+void thread_pool::work() {
+    for (size_t i = next_.fetch_add(1); i < count_; i = next_.fetch_add(1))
+        (*task_)(i);
+}
+
+void thread_pool::worker_loop() {
+    unsigned long seen = 0;
+    for (;;) {
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            start_cv_.wait(lock, [&] { return stop_ || generation_ != seen; });
+            if (stop_) return;
+            seen = generation_;
+        }
+        work();
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (--pending_ == 0) done_cv_.notify_one();
+    }
+}
+
+} //namespace mystl
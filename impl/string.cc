@@ -94,8 +94,8 @@ void string::resize(size_type n, char c) {
         size_type len_insert = n - size();
         size_type old_capacity = capacity();
         auto res = std::max(old_capacity, len_insert);
-        auto new_capacity = old_capacity + res;
-        iterator new_start_ = data_allocator::allocate(new_capacity);
+        size_type new_capacity = old_capacity + res;
+        iterator new_start_ = data_allocator::allocate_at_least(new_capacity, new_capacity);
         iterator new_finish_ = std::uninitialized_copy(start_, finish_, new_start_);
         new_finish_ = std::uninitialized_fill_n(new_finish_, len_insert, c);
 
@@ -103,19 +103,31 @@ void string::resize(size_type n, char c) {
         deallocate();
         start_ = new_start_;
         finish_ = new_finish_;
-        end_of_storage_ = start_ + n;
+        end_of_storage_ = start_ + new_capacity;
     }
 }
 
+//扩容策略与resize相同
+void string::resize_default_init(size_type n) {
+    if (n <= size()) {
+        finish_ = start_ + n;
+        return;
+    }
+    if (n > capacity()) reserve(capacity() + std::max(capacity(), n - size()));
+    finish_ = start_ + n;
+}
+
 void string::reserve(size_type n) {
     if (n <= capacity()) return;
-    iterator new_start_ = data_allocator::allocate(n);
+    size_type new_capacity;
+    //区块的余量也计入容量，之后的追加可少扩容几次
+    iterator new_start_ = data_allocator::allocate_at_least(n, new_capacity);
     iterator new_finish_ = std::uninitialized_copy(start_, finish_, new_start_);
     destroy(start_, finish_);
     deallocate();
     start_ = new_start_;
     finish_ = new_finish_;
-    end_of_storage_ = start_ + n;
+    end_of_storage_ = start_ + new_capacity;
 }
 
 string& string::insert(size_type pos, const char* s) {
@@ -149,8 +161,8 @@ typename string::iterator
 string::insert_fill_aux(iterator p, size_type n, value_type c){
     size_type old_capacity = capacity();
     auto res = std::max(old_capacity, n);
-    auto new_capacity = old_capacity + res;
-    iterator new_start_ = data_allocator::allocate(new_capacity);
+    size_type new_capacity = old_capacity + res;
+    iterator new_start_ = data_allocator::allocate_at_least(new_capacity, new_capacity);
     iterator new_finish_ = std::uninitialized_copy(start_, p, new_start_);
     new_finish_ = std::uninitialized_fill_n(new_finish_, n, c);
     auto tmp = new_finish_;
@@ -1,6 +1,8 @@
 #ifndef MYSTL_ITERATOR_H_
 #define MYSTL_ITERATOR_H_
 
+#include "typetraits.h"
+
 #include <cstddef> //for ptrdiff_t
 namespace mystl {
 
@@ -26,7 +28,7 @@ struct iterator_traits {
     typedef typename Iterator::iterator_category iterator_category;
     typedef typename Iterator::value_type        value_type;
     typedef typename Iterator::difference_type   difference_type;
-    typedef typename Iterator::Pointer           pointer;
+    typedef typename Iterator::pointer           pointer;
     typedef typename Iterator::reference         reference;
 };
 
@@ -71,6 +73,17 @@ value_type(const Iterator&) {
     return static_cast<typename iterator_traits<Iterator>::value_type*>(0);
 }
 
+//分段迭代器的traits：区间由若干段连续存储组成（如deque的各个缓冲区）时，
+//算法可逐段以原生指针处理，省去迭代器每一步的边界判断
+//容器为其迭代器特化本模板，令is_segmented_iterator为_true_type，并提供：
+//segment_iterator（遍历各段）、local_iterator（段内的原生指针）、
+//segment(it)与local(it)（拆分迭代器）、begin(s)与end(s)（段的首尾）、compose(s, p)（合成迭代器）
+//分段迭代器须可随机访问
+template<typename Iterator>
+struct segmented_iterator_traits {
+    typedef _false_type is_segmented_iterator;
+};
+
 } //namespace mystl
 
 #endif
@@ -86,8 +86,9 @@ struct _list_iterator {
 }; // struct _list_iterator
 
 //**********class list**********
+//list私有继承节点的空间配置器，无状态的Alloc不增加list的大小
 template<typename T, typename Alloc = alloc>
-class list {
+class list : private allocator<_list_node<T>, Alloc> {
 protected:
     typedef _list_node<T>        list_node;
     typedef allocator<list_node, Alloc>        list_node_allocator; // 空间配置器
@@ -100,6 +101,7 @@ public:
     typedef const value_type&    const_reference;
     typedef size_t               size_type;
     typedef ptrdiff_t            difference_type;
+    typedef Alloc                allocator_type;
 public:
     typedef _list_iterator<T, T&, T*>                iterator;
     typedef _list_iterator<T, const T&, const T*>    const_iterator;
@@ -109,6 +111,7 @@ protected:
 public:
     // 构造，析构，复制相关
     list() { empty_initialize(); } // 产生空的链表
+    explicit list(const allocator_type& a) : list_node_allocator(a) { empty_initialize(); }
     ~list() {
         clear();
         put_node(node); // 释放头结点
@@ -123,12 +126,14 @@ public:
     template<typename InputIterator>
     list(InputIterator first, InputIterator last) { range_initialize(first, last); }
 
-    list(const list<T, Alloc>& x) { // 复制构造
+    list(const list<T, Alloc>& x) : list_node_allocator(x) { // 复制构造，沿用x的配置器
         range_initialize(x.begin(), x.end());
     }
 
     list& operator=(const list<T, Alloc>& x);
 
+    allocator_type get_allocator() const { return list_node_allocator::policy(); }
+
     // 迭代器和容量相关
     iterator begin() { return node->next; }
     const_iterator begin() const { return node->next; }
@@ -159,7 +164,11 @@ public:
     //inline bool operator<(const list<T, Alloc>& x, const list<T, Alloc>& y);
 
     // 操作容器相关
-    void swap(list<T, Alloc>& x) { std::swap(node, x.node); }
+    // 配置器随节点一同交换
+    void swap(list<T, Alloc>& x) {
+        std::swap(node, x.node);
+        std::swap(static_cast<list_node_allocator&>(*this), static_cast<list_node_allocator&>(x));
+    }
 
     iterator insert(iterator position, const T& x);
     iterator insert(iterator position);
@@ -181,7 +190,7 @@ public:
     void pop_front() { erase(begin()); }
     void pop_back() { erase(--end()); }
 
-    // 将链表x移动到position之前
+    // 将链表x移动到position之前，splice与merge要求两个链表的配置器可以互相释放对方的节点
     void splice(iterator position, list& x);
     // 将链表中i指向的内容移动到position之前
     void splice(iterator position, list&, iterator i);
@@ -208,12 +217,30 @@ protected:
     void put_node(link_type p) { list_node_allocator::deallocate(p); }
 
     // 创建节点，分配内存后进行构造
-    link_type create_node(const T& x) {
-        link_type p = get_node();
-        construct(&p->data, x);
+    link_type create_node(const T& x) { return create_node(get_node(), x); }
+
+    // 在已分配的节点p上构造x，构造失败时释放p
+    link_type create_node(link_type p, const T& x) {
+        try {
+            construct(&p->data, x);
+        } catch(...) {
+            put_node(p);
+            throw;
+        }
         return p;
     }
 
+    // 将节点tmp链接到position之前
+    static void link_before(iterator position, link_type tmp) {
+        tmp->next = position.node;
+        tmp->prev = position.node->prev;
+        position.node->prev->next = tmp;
+        position.node->prev = tmp;
+    }
+
+    // 插入n个x，节点成批配置
+    void fill_insert(iterator position, size_type n, const T& x);
+
     // 析构节点元素，并释放内存
     void destroy_node(link_type p) {
         destroy(&(p->data));
@@ -297,10 +324,7 @@ template<typename T, typename Alloc>
 typename list<T, Alloc>::iterator
 list<T, Alloc>::insert(iterator position, const T& x) {
     link_type tmp = create_node(x);
-    tmp->next = position.node;
-    tmp->prev = position.node->prev;
-    position.node->prev->next = tmp;
-    position.node->prev = tmp;
+    link_before(position, tmp);
     return tmp;
 }
 
@@ -310,29 +334,37 @@ list<T, Alloc>::insert(iterator position) {
     return insert(position, T());
 }
 
+//区间长度未知，节点按node_batch_source逐批增大的数目配置
 template<typename T, typename Alloc>
 template<typename InputIterator>
 void list<T, Alloc>::insert(iterator position, InputIterator first, InputIterator last) {
+    node_batch_source<list_node, Alloc> batch(*this);
     for ( ; first != last; ++first)
-        insert(position, *first);
+        link_before(position, create_node(batch.get(), *first));
 }
 
 template<typename T, typename Alloc>
-void list<T, Alloc>::insert(iterator position, size_type n, const T& x) {
+void list<T, Alloc>::fill_insert(iterator position, size_type n, const T& x) {
+    node_batch_source<list_node, Alloc> batch(*this, n);
     for ( ; n > 0; --n)
-        insert(position, x);
+        link_before(position, create_node(batch.get(), x));
+}
+
+template<typename T, typename Alloc>
+void list<T, Alloc>::insert(iterator position, size_type n, const T& x) {
+    fill_insert(position, n, x);
 }
 
 template<typename T, typename Alloc>
 void list<T, Alloc>::insert(iterator position, int n, const T& x) {
-    for ( ; n > 0; --n)
-        insert(position, x);
+    if (n > 0)
+        fill_insert(position, static_cast<size_type>(n), x);
 }
 
 template<typename T, typename Alloc>
 void list<T, Alloc>::insert(iterator position, long n, const T& x) {
-    for ( ; n > 0; --n)
-        insert(position, x);
+    if (n > 0)
+        fill_insert(position, static_cast<size_type>(n), x);
 }
 
 template<typename T, typename Alloc>
@@ -369,11 +401,13 @@ void list<T, Alloc>::resize(size_type new_size, const T& x) {
 
 template<typename T, typename Alloc>
 void list<T, Alloc>::clear() {
+    node_batch_sink<list_node, Alloc> sink(*this);
     link_type cur = node->next;
     while (cur != node) {
         link_type tmp = cur;
         cur = cur->next;
-        destroy_node(tmp);
+        destroy(&tmp->data);
+        sink.put(tmp);
     }
     node->next = node;
     node->prev = node;
@@ -441,7 +475,7 @@ void list<T, Alloc>::merge(list<T, Alloc>& x) {
     while (first1 != last1 && first2 != last2) {
         if (*first2 < *first1) {
             iterator next = first2;
-            trandfer(first1, first2, ++next);
+            transfer(first1, first2, ++next);
             first2 = next;
         }
         else
@@ -483,7 +517,7 @@ void list<T, Alloc>::sort() {
     }
     for (int i = 1; i < fill; ++i)
         counter[i].merge(counter[i - 1]);
-    swap(counter[fill - 1]);
+    splice(end(), counter[fill - 1]); // 不用swap，以保留本链表的头结点与配置器
 }
 
 //给定一个仿函数，如果仿函数为真则进行相应的元素移除
@@ -556,7 +590,7 @@ void list<T, Alloc>::sort(StrictWeakOrdering comp) {
         if (i == fill) ++fill;
     }
     for (int i = 1; i < fill; ++i) counter[i].merge(counter[i - 1], comp);
-    swap(counter[fill - 1]);
+    splice(end(), counter[fill - 1]); // 不用swap，以保留本链表的头结点与配置器
 }
 
 } // namespace mystl
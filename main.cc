@@ -10,6 +10,14 @@
 //#include "./test/unordered_maptest.h"
 //#include "./test/stringtest.h"
 //#include "./test/algorithmtest.h"
+#include "./test/alloctest.h"
+#include "./test/arenatest.h"
+#include "./test/memory_resourcetest.h"
+#include "./test/small_vectortest.h"
+#include "./test/bvectortest.h"
+#include "./test/mapped_vectortest.h"
+#include "./test/segmented_vectortest.h"
+#include "./test/ring_buffertest.h"
 
 using namespace mystl;
 
@@ -25,6 +33,14 @@ int main() {
     //mystl::unordered_maptest::testAllCases();
     //mystl::stringtest::testAllCases();
     //mystl::algorithmtest::testAllCases();
+    mystl::alloctest::testAllCases();
+    mystl::arenatest::testAllCases();
+    mystl::memory_resourcetest::testAllCases();
+    mystl::small_vectortest::testAllCases();
+    mystl::bvectortest::testAllCases();
+    mystl::mapped_vectortest::testAllCases();
+    mystl::segmented_vectortest::testAllCases();
+    mystl::ring_buffertest::testAllCases();
 
 	return 0;
 }
@@ -62,9 +62,11 @@ public:
     typedef typename rep_type::const_iterator const_iterator;
     typedef typename rep_type::size_type size_type;
     typedef typename rep_type::difference_type difference_type;  // STL标准强制要求
+    typedef typename rep_type::allocator_type allocator_type;
 
     map() : t(Compare()) {}
     explicit map(const Compare& comp) : t(comp) {}
+    map(const Compare& comp, const allocator_type& a) : t(comp, a) {}
 
     template<typename InputIterator>
     map(InputIterator first, InputIterator last)
@@ -81,6 +83,7 @@ public:
         return *this;
     }
 
+    allocator_type get_allocator() const { return t.get_allocator(); }
     key_compare key_comp() const { return t.key_comp(); }
 
     value_type value_comp() const { return value_compare(t.key_comp()); } // 实际未使用
@@ -0,0 +1,255 @@
+#ifndef MYSTL_MAPPED_VECTOR_H_
+#define MYSTL_MAPPED_VECTOR_H_
+
+#include <algorithm> //for max
+#include <cstddef> //for size_t, ptrdiff_t
+#include <memory> //for uninitialized_fill
+#include <stdexcept> //for out_of_range, runtime_error
+#include <type_traits> //for is_trivially_copyable
+
+namespace mystl {
+
+//以mmap共享映射整个文件，文件长度可调整，调整后映射的地址可能改变
+class mapped_file {
+public:
+    enum open_mode { read_only, read_write };
+
+private:
+    int fd_;
+    char *data_;
+    size_t length_; //文件与映射的长度
+    bool writable_;
+private:
+    mapped_file(const mapped_file&);
+    mapped_file& operator=(const mapped_file&);
+
+public:
+    mapped_file() : fd_(-1), data_(0), length_(0), writable_(false) {}
+    ~mapped_file() { close(); }
+
+    //打开并映射path，read_write时文件不存在则创建；失败时抛出runtime_error
+    void open(const char *path, open_mode mode);
+    //解除映射并关闭文件，修改由内核写回文件
+    void close();
+    //调整文件长度并重新映射，新增的部分为0，只读时抛出logic_error
+    void resize(size_t length);
+    //将映射中的修改同步写回文件
+    void sync();
+
+    bool is_open() const { return fd_ != -1; }
+    bool writable() const { return writable_; }
+    char *data() const { return data_; }
+    size_t length() const { return length_; }
+};
+
+//元素存放在内存映射文件中的vector，只适用于可平凡复制的T
+//文件//mapped_vector与mapped_view共用的部分：文件头的格式与校验，元素区的位置
+//文件头记录元素大小与个数，重新打开时只需映射文件，不需要逐个读取与构造元素
+template<typename T>
+class _mapped_array {
+    static_assert(std::is_trivially_copyable<T>::value,
+                  "mapped_vector requires a trivially copyable value type");
+
+public:
+    typedef size_t              size_type;
+
+protected:
+    //文件头，占HEADER_SIZE字节，元素从其后开始
+    struct header {
+        unsigned long long magic;
+        unsigned long long value_size;
+        unsigned long long size; //元素个数
+    };
+    enum { HEADER_SIZE = 64 };
+    static const unsigned long long MAGIC = 0x4d59535456454331ULL; //"MYSTVEC1"
+    static_assert(alignof(T) <= HEADER_SIZE, "value type is over-aligned for mapped_vector");
+
+    mapped_file file_;
+
+    header *head() const { return reinterpret_cast<header *>(file_.data()); }
+    //未打开时data()为空，不能在空指针上加偏移
+    T *start() const {
+        return is_open() ? reinterpret_cast<T *>(file_.data() + HEADER_SIZE) : 0;
+    }
+    //打开path，可写且新建的文件写入文件头并预留capacity个元素；
+    //已有的文件校验文件头，不匹配时抛出runtime_error
+    void open_file(const char *path, mapped_file::open_mode mode, size_type capacity);
+
+    _mapped_array() {}
+private:
+    _mapped_array(const _mapped_array&);
+    _mapped_array& operator=(const _mapped_array&);
+
+public:
+    void close() { file_.close(); }
+    bool is_open() const { return file_.is_open(); }
+    size_type size() const { return is_open() ? static_cast<size_type>(head()->size) : 0; }
+    bool empty() const { return size() == 0; }
+};
+
+template<typename T>
+void _mapped_array<T>::open_file(const char *path, mapped_file::open_mode mode,
+                                 size_type capacity) {
+    file_.open(path, mode);
+    if (file_.length() == 0 && file_.writable()) { //新建的文件
+        file_.resize(HEADER_SIZE + capacity * sizeof(T));
+        head()->magic = MAGIC;
+        head()->value_size = sizeof(T);
+        head()->size = 0;
+        return;
+    }
+    if (file_.length() < HEADER_SIZE || head()->magic != MAGIC
+        || head()->value_size != sizeof(T)
+        || head()->size > (file_.length() - HEADER_SIZE) / sizeof(T)) {
+        file_.close();
+        throw std::runtime_error("mapped_vector: bad file header");
+    }
+}
+
+//元素存放在内存映射文件中的vector，只适用于可平凡复制的T
+//总是以read_write打开，只读访问使用mapped_view
+//文件长度即容量，push_back与resize在容量不足时按2倍扩展文件；扩展后原有的迭代器与引用失效
+template<typename T>
+class mapped_vector : public _mapped_array<T> {
+public:
+    typedef T                   value_type;
+    typedef value_type*         pointer;
+    typedef const value_type*   const_pointer;
+    typedef value_type*         iterator;
+    typedef const value_type*   const_iterator;
+    typedef value_type&         reference;
+    typedef const value_type&   const_reference;
+    typedef size_t              size_type;
+    typedef ptrdiff_t           difference_type;
+
+private:
+    typedef _mapped_array<T> base;
+    enum { INITIAL_CAPACITY = 4096 / sizeof(T) ? 4096 / sizeof(T) : 1 };
+
+    using base::file_;
+    using base::head;
+    using base::start;
+
+    void set_size(size_type n) { head()->size = n; }
+    //将文件调整为恰好容纳n个元素
+    void resize_file(size_type n) { file_.resize(base::HEADER_SIZE + n * sizeof(T)); }
+
+public:
+    mapped_vector() {}
+    explicit mapped_vector(const char *path) { open(path); }
+
+    //打开path，文件不存在则创建
+    void open(const char *path) { this->open_file(path, mapped_file::read_write, INITIAL_CAPACITY); }
+    void sync() { file_.sync(); }
+
+    //迭代器和容量相关
+    iterator begin() { return start(); }
+    const_iterator begin() const { return start(); }
+    const_iterator cbegin() const { return start(); }
+    iterator end() { return start() + this->size(); }
+    const_iterator end() const { return start() + this->size(); }
+    const_iterator cend() const { return end(); }
+    size_type capacity() const {
+        return this->is_open() ? (file_.length() - base::HEADER_SIZE) / sizeof(T) : 0;
+    }
+    void reserve(size_type n) {
+        if (n > capacity()) resize_file(n);
+    }
+    void resize(size_type n) { resize(n, T()); }
+    void resize(size_type n, const value_type& value);
+    void shrink_to_fit() {
+        if (capacity() > this->size()) resize_file(this->size());
+    }
+
+    //访问元素相关
+    reference operator[](size_type n) { return start()[n]; }
+    const_reference operator[](size_type n) const { return start()[n]; }
+    const_reference at(size_type n) const {
+        if (n >= this->size()) throw std::out_of_range("mapped_vector::at");
+        return start()[n];
+    }
+    reference at(size_type n) {
+        if (n >= this->size()) throw std::out_of_range("mapped_vector::at");
+        return start()[n];
+    }
+    reference front() { return *begin(); }
+    const_reference front() const { return *begin(); }
+    reference back() { return *(end() - 1); }
+    const_reference back() const { return *(end() - 1); }
+    pointer data() { return start(); }
+    const_pointer data() const { return start(); }
+
+    //操作容器相关
+    void push_back(const value_type& value);
+    void pop_back() { set_size(this->size() - 1); }
+    void clear() { set_size(0); }
+};
+
+//以PROT_READ共享映射打开mapped_vector写出的文件，只提供const访问
+//文件必须已存在；其他进程经mapped_vector的修改在此可见
+template<typename T>
+class mapped_view : public _mapped_array<T> {
+public:
+    typedef T                   value_type;
+    typedef const value_type*   pointer;
+    typedef const value_type*   const_pointer;
+    typedef const value_type*   iterator;
+    typedef const value_type*   const_iterator;
+    typedef const value_type&   reference;
+    typedef const value_type&   const_reference;
+    typedef size_t              size_type;
+    typedef ptrdiff_t           difference_type;
+
+private:
+    typedef _mapped_array<T> base;
+    using base::start;
+
+public:
+    mapped_view() {}
+    explicit mapped_view(const char *path) { open(path); }
+
+    void open(const char *path) { this->open_file(path, mapped_file::read_only, 0); }
+
+    const_iterator begin() const { return start(); }
+    const_iterator cbegin() const { return start(); }
+    const_iterator end() const { return start() + this->size(); }
+    const_iterator cend() const { return end(); }
+
+    const_reference operator[](size_type n) const { return start()[n]; }
+    const_reference at(size_type n) const {
+        if (n >= this->size()) throw std::out_of_range("mapped_view::at");
+        return start()[n];
+    }
+    const_reference front() const { return *begin(); }
+    const_reference back() const { return *(end() - 1); }
+    const_pointer data() const { return start(); }
+};
+
+//value可能引用本mapped_vector中的元素，扩展文件前先复制
+template<typename T>
+void mapped_vector<T>::push_back(const value_type& value) {
+    size_type n = this->size();
+    if (n == capacity()) {
+        value_type val_copy = value;
+        resize_file(std::max<size_type>(2 * n, INITIAL_CAPACITY));
+        start()[n] = val_copy;
+    } else {
+        start()[n] = value;
+    }
+    set_size(n + 1);
+}
+
+template<typename T>
+void mapped_vector<T>::resize(size_type n, const value_type& value) {
+    size_type old_size = this->size();
+    if (n > old_size) {
+        value_type val_copy = value;
+        if (n > capacity()) resize_file(std::max(n, 2 * old_size));
+        std::uninitialized_fill(start() + old_size, start() + n, val_copy);
+    }
+    set_size(n);
+}
+
+} //namespace mystl
+
+#endif
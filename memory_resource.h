@@ -0,0 +1,85 @@
+#ifndef MYSTL_MEMORY_RESOURCE_H_
+#define MYSTL_MEMORY_RESOURCE_H_
+
+#include "arena.h"
+
+#include <cstddef> //for size_t
+
+namespace mystl {
+
+//多态的内存来源：容器通过resource_alloc持有其指针，
+//不同的容器实例可以从不同的内存区域（请求、分片、线程等）分配
+class memory_resource {
+public:
+    virtual ~memory_resource() {}
+
+    void *allocate(size_t bytes) { return do_allocate(bytes); }
+    void deallocate(void *p, size_t bytes) { do_deallocate(p, bytes); }
+    //由一方分配的内存能否由另一方释放
+    bool is_equal(const memory_resource& other) const {
+        return this == &other || do_is_equal(other);
+    }
+
+protected:
+    virtual void *do_allocate(size_t bytes) = 0;
+    virtual void do_deallocate(void *p, size_t bytes) = 0;
+    virtual bool do_is_equal(const memory_resource&) const { return false; }
+};
+
+inline bool operator==(const memory_resource& a, const memory_resource& b) {
+    return a.is_equal(b);
+}
+
+inline bool operator!=(const memory_resource& a, const memory_resource& b) {
+    return !(a == b);
+}
+
+//以alloc内存池为来源的memory_resource，全局唯一
+memory_resource *pool_resource();
+//resource_alloc默认使用的memory_resource，初始为pool_resource()
+memory_resource *get_default_resource();
+//设置默认的memory_resource，传入0时恢复为pool_resource()，返回原先的值
+memory_resource *set_default_resource(memory_resource *r);
+
+//以monotonic_arena为来源：deallocate不做任何事，release()或析构时一次性归还全部内存
+class monotonic_resource : public memory_resource {
+private:
+    monotonic_arena arena_;
+public:
+    monotonic_resource() {}
+    void release() { arena_.release(); }
+    //自上次release以来分配的字节数
+    size_t bytes_allocated() const { return arena_.bytes_allocated(); }
+
+protected:
+    virtual void *do_allocate(size_t bytes);
+    virtual void do_deallocate(void *p, size_t bytes);
+};
+
+//持有memory_resource指针的配置策略，作为容器的Alloc参数，例如
+//    monotonic_resource request_memory;
+//    list<int, resource_alloc> lst(&request_memory);
+//容器的拷贝构造沿用源容器的resource，swap和移动随内存一同交换resource
+class resource_alloc {
+private:
+    memory_resource *resource_;
+public:
+    resource_alloc() : resource_(get_default_resource()) {}
+    resource_alloc(memory_resource *r) : resource_(r) {}
+
+    void *allocate(size_t n) { return resource_->allocate(n); }
+    void deallocate(void *p, size_t n) { resource_->deallocate(p, n); }
+    memory_resource *resource() const { return resource_; }
+};
+
+inline bool operator==(const resource_alloc& a, const resource_alloc& b) {
+    return *a.resource() == *b.resource();
+}
+
+inline bool operator!=(const resource_alloc& a, const resource_alloc& b) {
+    return !(a == b);
+}
+
+}//namespace mystl
+
+#endif
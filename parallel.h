@@ -0,0 +1,120 @@
+#ifndef MYSTL_PARALLEL_H_
+#define MYSTL_PARALLEL_H_
+
+#include "construct.h"
+
+#include <algorithm> //for min
+#include <atomic> //for atomic
+#include <condition_variable> //for condition_variable
+#include <cstddef> //for size_t
+#include <exception> //for exception_ptr
+#include <functional> //for function
+#include <memory> //for uninitialized_fill_n, uninitialized_copy, unique_ptr
+#include <mutex> //for mutex
+#include <thread> //for thread
+
+namespace mystl {
+
+//并行初始化：总字节数达到阈值的填充与复制分块交给线程池，每个线程只写自己的块，
+//页面由首先写入它的线程触发缺页，NUMA系统上因此分布到各线程所在的节点
+//阈值为0时关闭（默认），需要时由使用者显式开启
+void set_parallel_threshold(size_t bytes);
+size_t parallel_threshold();
+
+//进程内共享的线程池，第一次使用时按硬件线程数创建，调用线程也参与计算
+class thread_pool {
+public:
+    static thread_pool& instance();
+
+    //执行task(0)到task(count - 1)，全部完成后返回，task不能抛出异常
+    //线程池正被占用（包括在任务中再次调用）时由调用线程依次执行
+    void run(size_t count, const std::function<void(size_t)>& task);
+    //可同时执行任务的线程数，包括调用线程
+    size_t concurrency() const { return workers_ + 1; }
+
+    ~thread_pool();
+
+private:
+    thread_pool();
+    thread_pool(const thread_pool&);
+    thread_pool& operator=(const thread_pool&);
+
+    void worker_loop();
+    void work(); //领取并执行任务，直到任务全部被领取
+
+    size_t workers_; //工作线程数
+    std::thread *threads_;
+    std::atomic<bool> busy_; //同一时刻只执行一批任务
+
+    std::mutex mutex_;
+    std::condition_variable start_cv_;
+    std::condition_variable done_cv_;
+    const std::function<void(size_t)> *task_; //当前这批任务
+    size_t count_;
+    std::atomic<size_t> next_; //下一个待领取的任务
+    size_t pending_; //尚未完成当前这批任务的工作线程数
+    unsigned long generation_; //每批任务加1，工作线程据此发现新任务
+    bool stop_;
+};
+
+//将n个元素分为chunks块时第i块的起始下标
+inline size_t _chunk_begin(size_t n, size_t chunks, size_t i) {
+    return i * (n / chunks) + std::min(i, n % chunks);
+}
+
+//初始化n个T应分成的块数，未达到阈值时为1
+template<typename T>
+size_t _parallel_chunks(size_t n) {
+    size_t threshold = parallel_threshold();
+    if (threshold == 0 || n < 2 || n * sizeof(T) < threshold) return 1;
+    return std::min(thread_pool::instance().concurrency(), n);
+}
+
+//在result处分块构造n个对象，construct(first, last)构造下标为[first, last)的对象，
+//中途抛出异常时已构造的部分由其自行析构；有块失败时析构其余各块，再重新抛出第一个异常
+template<typename T, typename Construct>
+void _parallel_construct(T *result, size_t n, size_t chunks, Construct construct) {
+    std::unique_ptr<std::exception_ptr[]> errors(new std::exception_ptr[chunks]);
+    thread_pool::instance().run(chunks, [&](size_t i) {
+        try {
+            construct(_chunk_begin(n, chunks, i), _chunk_begin(n, chunks, i + 1));
+        } catch(...) {
+            errors[i] = std::current_exception();
+        }
+    });
+    for (size_t i = 0; i != chunks; ++i) {
+        if (!errors[i]) continue;
+        for (size_t j = 0; j != chunks; ++j) {
+            if (!errors[j])
+                destroy(result + _chunk_begin(n, chunks, j), result + _chunk_begin(n, chunks, j + 1));
+        }
+        std::rethrow_exception(errors[i]);
+    }
+}
+
+//达到阈值时并行的uninitialized_fill_n，各线程并发读取value
+template<typename T>
+T *parallel_uninitialized_fill_n(T *first, size_t n, const T& value) {
+    size_t chunks = _parallel_chunks<T>(n);
+    if (chunks == 1) return std::uninitialized_fill_n(first, n, value);
+    _parallel_construct(first, n, chunks, [&](size_t from, size_t to) {
+        std::uninitialized_fill_n(first + from, to - from, value);
+    });
+    return first + n;
+}
+
+//达到阈值时并行的uninitialized_copy，各线程并发读取源区间
+template<typename T>
+T *parallel_uninitialized_copy(const T *first, const T *last, T *result) {
+    size_t n = static_cast<size_t>(last - first);
+    size_t chunks = _parallel_chunks<T>(n);
+    if (chunks == 1) return std::uninitialized_copy(first, last, result);
+    _parallel_construct(result, n, chunks, [&](size_t from, size_t to) {
+        std::uninitialized_copy(first + from, first + to, result + from);
+    });
+    return result + n;
+}
+
+} //namespace mystl
+
+#endif
@@ -0,0 +1,75 @@
+
+#include <iostream>
+#include <deque>
+#include <string>
+
+#include "../deque.h"
+#include "../string.h"
+#include "profiler.h"
+
+//**********统计malloc调用次数**********
+//覆盖glibc的malloc，转发给__libc_malloc并计数
+static size_t malloc_calls = 0;
+
+extern "C" void *__libc_malloc(size_t n);
+extern "C" void *malloc(size_t n) {
+    ++malloc_calls;
+    return __libc_malloc(n);
+}
+
+static void report(const char *name, size_t calls) {
+    std::cout << name << ":" << std::endl;
+    mystl::profiler::ProfilerInstance::print_time();
+    std::cout << "malloc calls: " << calls << std::endl;
+}
+
+int main() {
+    const int kRounds = 1000;
+    const int kElements = 2000;
+    size_t calls;
+
+//**********mystl::deque**********
+    //deque的缓冲区为512字节，每轮反复创建与销毁
+    calls = malloc_calls;
+    mystl::profiler::ProfilerInstance::start();
+    for (int round = 0; round != kRounds; ++round) {
+        mystl::deque<int> mydq;
+        for (int i = 0; i != kElements; ++i) mydq.push_back(i);
+    }
+    mystl::profiler::ProfilerInstance::finish();
+    report("mystl::deque(1000 x 2000)", malloc_calls - calls);
+
+//**********std::deque**********
+    calls = malloc_calls;
+    mystl::profiler::ProfilerInstance::start();
+    for (int round = 0; round != kRounds; ++round) {
+        std::deque<int> stddq;
+        for (int i = 0; i != kElements; ++i) stddq.push_back(i);
+    }
+    mystl::profiler::ProfilerInstance::finish();
+    report("std::deque(1000 x 2000)", malloc_calls - calls);
+
+//**********mystl::string**********
+    //字符串长度在129到4224字节之间，逐段追加
+    calls = malloc_calls;
+    mystl::profiler::ProfilerInstance::start();
+    for (int round = 0; round != kRounds; ++round) {
+        mystl::string mystr(129 + round % 64, 'x');
+        for (int i = 0; i != 64; ++i) mystr.append(64, 'y');
+    }
+    mystl::profiler::ProfilerInstance::finish();
+    report("mystl::string(1000 x 64 appends)", malloc_calls - calls);
+
+//**********std::string**********
+    calls = malloc_calls;
+    mystl::profiler::ProfilerInstance::start();
+    for (int round = 0; round != kRounds; ++round) {
+        std::string stdstr(129 + round % 64, 'x');
+        for (int i = 0; i != 64; ++i) stdstr.append(64, 'y');
+    }
+    mystl::profiler::ProfilerInstance::finish();
+    report("std::string(1000 x 64 appends)", malloc_calls - calls);
+
+//**********内存池统计**********
+    mystl::alloc::print_stats(std::cout);
+}
@@ -0,0 +1,83 @@
+#include <iostream>
+#include <vector>
+
+#include "../algorithm.h"
+#include "../deque.h"
+#include "profiler.h"
+
+//**********deque上的批量算法**********
+//mystl的算法对deque逐段以原生指针处理，与同样的算法处理vector以及逐个元素处理deque对比
+const int kSize = 10000000;
+const int kRounds = 20;
+
+template<typename Fn>
+void measure(const char *name, Fn fn) {
+    long long checksum = 0;
+    mystl::profiler::ProfilerInstance::start();
+    for (int i = 0; i != kRounds; ++i) checksum += fn(i);
+    mystl::profiler::ProfilerInstance::finish();
+    std::cout << name << "(" << kRounds << " x " << kSize << " ints, checksum " << checksum << "):" << std::endl;
+    mystl::profiler::ProfilerInstance::print_time();
+}
+
+//逐个元素经deque迭代器访问，每一步都要判断缓冲区边界
+template<typename Iterator>
+void loop_fill(Iterator first, Iterator last, int value) {
+    for (; first != last; ++first) *first = value;
+}
+
+template<typename Iterator>
+int *loop_copy(Iterator first, Iterator last, int *result) {
+    for (; first != last; ++first, ++result) *result = *first;
+    return result;
+}
+
+template<typename Iterator>
+Iterator loop_find(Iterator first, Iterator last, int value) {
+    for (; first != last; ++first) if (*first == value) break;
+    return first;
+}
+
+int main() {
+    std::vector<int> buf(kSize);
+    std::vector<int> vec(kSize, 0);
+    mystl::deque<int> dq(kSize, 0);
+    int *vb = vec.data(), *ve = vec.data() + kSize;
+
+    measure("mystl::fill on vector", [&](int i) { mystl::fill(vb, ve, i); return vec[kSize / 2]; });
+    measure("mystl::fill on deque", [&](int i) {
+        mystl::fill(dq.begin(), dq.end(), i);
+        return dq[kSize / 2];
+    });
+    measure("element loop fill on deque", [&](int i) {
+        loop_fill(dq.begin(), dq.end(), i);
+        return dq[kSize / 2];
+    });
+
+    measure("mystl::copy from vector", [&](int) { mystl::copy(vb, ve, buf.data()); return buf[kSize - 1]; });
+    measure("mystl::copy from deque", [&](int) {
+        mystl::copy(dq.begin(), dq.end(), buf.data());
+        return buf[kSize - 1];
+    });
+    measure("element loop copy from deque", [&](int) {
+        loop_copy(dq.begin(), dq.end(), buf.data());
+        return buf[kSize - 1];
+    });
+
+    measure("mystl::find on vector", [&](int) {
+        return static_cast<long long>(mystl::find(vb, ve, -1) - vb);
+    });
+    measure("mystl::find on deque", [&](int) {
+        return static_cast<long long>(mystl::find(dq.begin(), dq.end(), -1) - dq.begin());
+    });
+    measure("element loop find on deque", [&](int) {
+        return static_cast<long long>(loop_find(dq.begin(), dq.end(), -1) - dq.begin());
+    });
+
+    measure("mystl::equal on vector", [&](int) {
+        return static_cast<long long>(mystl::equal(vb, ve, buf.data()));
+    });
+    measure("mystl::equal on deque", [&](int) {
+        return static_cast<long long>(mystl::equal(dq.begin(), dq.end(), buf.data()));
+    });
+}
@@ -0,0 +1,66 @@
+#include <iostream>
+#include <queue>
+#include <deque>
+
+#include "../queue.h"
+#include "../ring_buffer.h"
+#include "profiler.h"
+
+//**********统计缓冲区的配置次数**********
+//mystl::deque与ring_buffer经配置策略计数，std::deque覆盖glibc的malloc计数
+static size_t policy_calls = 0;
+static size_t malloc_calls = 0;
+
+struct counting_alloc {
+    static void *allocate(size_t n) {
+        ++policy_calls;
+        return mystl::alloc::allocate(n);
+    }
+    static void deallocate(void *p, size_t n) { mystl::alloc::deallocate(p, n); }
+};
+
+extern "C" void *__libc_malloc(size_t n);
+extern "C" void *malloc(size_t n) {
+    ++malloc_calls;
+    return __libc_malloc(n);
+}
+
+//队列保持kDepth个元素，每次入队一个、出队一个，首尾不断跨过缓冲区边界
+template<typename Queue>
+void steady_state(Queue& q, const char *name, size_t& calls) {
+    const int kDepth = 100;
+    const int kOps = 100000000;
+    for (int i = 0; i != kDepth; ++i) q.push(i);
+    size_t before = calls;
+    long long sum = 0;
+    mystl::profiler::ProfilerInstance::start();
+    for (int i = 0; i != kOps; ++i) {
+        q.push(i);
+        sum += q.front();
+        q.pop();
+    }
+    mystl::profiler::ProfilerInstance::finish();
+    std::cout << name << "(depth " << kDepth << ", " << kOps << " push/pop):" << std::endl;
+    mystl::profiler::ProfilerInstance::print_time();
+    std::cout << "allocations: " << calls - before << " (checksum " << sum << ")" << std::endl;
+}
+
+int main() {
+//**********mystl::queue**********
+    {
+        mystl::queue<int, mystl::deque<int, counting_alloc>> myq;
+        steady_state(myq, "mystl::queue", policy_calls);
+    }
+
+//**********mystl::queue on ring_buffer**********
+    {
+        mystl::queue<int, mystl::ring_buffer<int, counting_alloc>> rbq;
+        steady_state(rbq, "mystl::queue<ring_buffer>", policy_calls);
+    }
+
+//**********std::queue**********
+    {
+        std::queue<int> stdq;
+        steady_state(stdq, "std::queue", malloc_calls);
+    }
+}
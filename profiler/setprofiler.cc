@@ -0,0 +1,68 @@
+
+#include <iostream>
+#include <cstdlib>
+#include <cstring>
+
+#include "../set.h"
+#include "profiler.h"
+
+//用法：setprofiler [hugepage] [节点数]
+//开启hugepage时，set的节点从大页arena中分配
+int main(int argc, char *argv[]) {
+    bool huge_page = false;
+    size_t n = 10000000;
+    for (int i = 1; i < argc; ++i) {
+        if (strcmp(argv[i], "hugepage") == 0) huge_page = true;
+        else n = strtoul(argv[i], 0, 10);
+    }
+    mystl::alloc::set_huge_page_arena(huge_page);
+
+//**********构造**********
+    //以线性同余序列打乱插入顺序，使相邻节点在内存中不相邻
+    mystl::set<size_t> myset;
+    size_t key = 1;
+    mystl::profiler::ProfilerInstance::start();
+    for (size_t i = 0; i != n; ++i) {
+        key = key * 6364136223846793005ULL + 1442695040888963407ULL;
+        myset.insert(key >> 16);
+    }
+    mystl::profiler::ProfilerInstance::finish();
+    std::cout << "mystl::set insert(" << n << ")"
+        << (huge_page ? " [hugepage]" : "") << ":" << std::endl;
+    mystl::profiler::ProfilerInstance::print_time();
+
+//**********查找**********
+    //按相同序列查找，每次查找都随机访问整棵树
+    size_t found = 0;
+    key = 1;
+    mystl::profiler::ProfilerInstance::start();
+    for (size_t i = 0; i != n; ++i) {
+        key = key * 6364136223846793005ULL + 1442695040888963407ULL;
+        found += myset.find(key >> 16) != myset.end();
+    }
+    mystl::profiler::ProfilerInstance::finish();
+    std::cout << "mystl::set find(" << n << ")"
+        << (huge_page ? " [hugepage]" : "") << ":" << std::endl;
+    mystl::profiler::ProfilerInstance::print_time();
+    std::cout << "found: " << found << std::endl;
+
+//**********复制与清空**********
+    //复制构造与clear成批配置和归还节点
+    {
+        mystl::profiler::ProfilerInstance::start();
+        mystl::set<size_t> copy(myset);
+        mystl::profiler::ProfilerInstance::finish();
+        std::cout << "mystl::set copy(" << copy.size() << "):" << std::endl;
+        mystl::profiler::ProfilerInstance::print_time();
+
+        mystl::profiler::ProfilerInstance::start();
+        copy.clear();
+        mystl::profiler::ProfilerInstance::finish();
+        std::cout << "mystl::set clear(" << myset.size() << "):" << std::endl;
+        mystl::profiler::ProfilerInstance::print_time();
+    }
+
+//**********memory()**********
+    std::cout << "当前最大驻留集：" << mystl::profiler::ProfilerInstance::memory()
+        << " kb" << std::endl;
+}
@@ -17,6 +17,32 @@ int main() {
     std::cout << "mystl::vector(100000):" << std::endl;
     mystl::profiler::ProfilerInstance::print_time();
 
+//**********大vector扩容：mystl::vector经realloc扩展，不再同时持有新旧两块缓冲区**********
+    {
+        mystl::vector<int> bigvec;
+        mystl::profiler::ProfilerInstance::start();
+        for (i = 0; i != 50000000; ++i) {
+            bigvec.push_back(i);
+        }
+        mystl::profiler::ProfilerInstance::finish();
+        std::cout << "mystl::vector(50000000):" << std::endl;
+        mystl::profiler::ProfilerInstance::print_time();
+        std::cout << "最大驻留集：" << mystl::profiler::ProfilerInstance::memory()
+            << " kb" << std::endl;
+    }
+    {
+        std::vector<int> bigvec;
+        mystl::profiler::ProfilerInstance::start();
+        for (i = 0; i != 50000000; ++i) {
+            bigvec.push_back(i);
+        }
+        mystl::profiler::ProfilerInstance::finish();
+        std::cout << "std::vector(50000000):" << std::endl;
+        mystl::profiler::ProfilerInstance::print_time();
+        std::cout << "最大驻留集：" << mystl::profiler::ProfilerInstance::memory()
+            << " kb" << std::endl;
+    }
+
 //**********std::vector**********
     std::vector<int> stdvec;
     mystl::profiler::ProfilerInstance::start();
@@ -133,9 +133,10 @@ inline bool operator!=(const _rb_tree_base_iterator& x,
 }
 
 // class rb_tree
+//rb_tree私有继承节点的空间配置器，无状态的Alloc不增加rb_tree的大小
 template<typename Key, typename Value, typename KeyOfValue, typename Compare,
          typename Alloc = alloc>
-class rb_tree {
+class rb_tree : private allocator<_rb_tree_node<Value>, Alloc> {
 protected:
     typedef void*                               void_pointer;
     typedef _rb_tree_node_base*                 base_ptr;
@@ -148,11 +149,12 @@ public:
     typedef Value                               value_type;
     typedef value_type*                         pointer;
     typedef const value_type*                   const_pointer;
-    typedef value_type                          reference;
+    typedef value_type&                         reference;
     typedef const value_type&                   const_reference;
     typedef rb_tree_node*                       link_type;
     typedef size_t                              size_type;
     typedef ptrdiff_t                           difference_type;
+    typedef Alloc                               allocator_type;
 public:
     typedef _rb_tree_iterator<value_type, reference, pointer> iterator;
     typedef _rb_tree_iterator<value_type, const_reference, const_pointer> const_iterator;
@@ -165,8 +167,10 @@ protected:
     link_type get_node() { return rb_tree_node_allocator::allocate(); }
     void put_node(link_type p) { rb_tree_node_allocator::deallocate(p); }
 
-    link_type create_node(const value_type& x) {
-        link_type tmp = get_node();
+    link_type create_node(const value_type& x) { return create_node(get_node(), x); }
+
+    // 在已配置的节点tmp上构造x，构造失败时释放tmp
+    link_type create_node(link_type tmp, const value_type& x) {
         try {
             construct(&tmp->value, x);
         } catch(...) {
@@ -176,8 +180,9 @@ protected:
         return tmp;
     }
 
-    link_type clone_node(link_type x) {
-        link_type tmp = create_node(x->value);
+    template<typename NodeGen>
+    link_type clone_node(link_type x, NodeGen& gen) {
+        link_type tmp = gen(x->value);
         tmp->color = x->color;
         tmp->left = 0;
         tmp->right = 0;
@@ -188,6 +193,26 @@ protected:
         destroy(&p->value);
         put_node(p);
     }
+
+    // 以下两个函数对象为插入和复制生成节点：
+    // node_creator逐个配置节点，batch_node_creator从成批配置的节点中取用，用于区间插入和复制
+    class node_creator {
+    public:
+        explicit node_creator(rb_tree& t) : tree(t) {}
+        link_type operator()(const value_type& x) { return tree.create_node(x); }
+    private:
+        rb_tree& tree;
+    };
+
+    class batch_node_creator {
+    public:
+        batch_node_creator(rb_tree& t, size_type expected)
+            : tree(t), batch(static_cast<rb_tree_node_allocator&>(t), expected) {}
+        link_type operator()(const value_type& x) { return tree.create_node(batch.get(), x); }
+    private:
+        rb_tree& tree;
+        node_batch_source<rb_tree_node, Alloc> batch;
+    };
 protected:
     // 以下三个函数用于取得header成员
     link_type& root() const { return (link_type&)(header->parent); }
@@ -217,9 +242,24 @@ protected:
         return static_cast<link_type>(_rb_tree_node_base::maximum(x));
     }
 private:
-    iterator _insert(base_ptr x, base_ptr y, const value_type& v);
-    link_type _copy(link_type x, link_type y);
-    void _erase(link_type x);
+    iterator _insert(base_ptr x, base_ptr y, const value_type& v) {
+        node_creator gen(*this);
+        return _insert(x, y, v, gen);
+    }
+    template<typename NodeGen>
+    iterator _insert(base_ptr x, base_ptr y, const value_type& v, NodeGen& gen);
+    template<typename NodeGen>
+    pair<iterator, bool> _insert_unique(const value_type& v, NodeGen& gen);
+    template<typename NodeGen>
+    iterator _insert_equal(const value_type& v, NodeGen& gen);
+    template<typename NodeGen>
+    link_type _copy(link_type x, link_type y, NodeGen& gen);
+    // 析构以x为根的子树，节点攒成一批后归还配置器
+    void _erase(link_type x) {
+        node_batch_sink<rb_tree_node, Alloc> sink(*this);
+        _erase(x, sink);
+    }
+    void _erase(link_type x, node_batch_sink<rb_tree_node, Alloc>& sink);
     void init() {
         header = get_node();
         color(header) = _rb_tree_red;
@@ -231,8 +271,11 @@ public:
     // 构造，析构相关
     rb_tree(const Compare& comp = Compare())
         : node_count(0), key_compare(comp) { init(); }
+    rb_tree(const Compare& comp, const allocator_type& a)
+        : rb_tree_node_allocator(a), node_count(0), key_compare(comp) { init(); }
+    // 沿用x的配置器
     rb_tree(const rb_tree<Key, Value, KeyOfValue, Compare, Alloc>& x)
-        : node_count(0), key_compare(x.key_compare) {
+        : rb_tree_node_allocator(x), node_count(0), key_compare(x.key_compare) {
         header = get_node();
         color(header) = _rb_tree_red;
         if (x.root() == 0) {
@@ -241,7 +284,8 @@ public:
             rightmost() = header;
         } else {
             try {
-                root() = _copy(x.root(), header);
+                batch_node_creator gen(*this, x.node_count);
+                root() = _copy(x.root(), header, gen);
             }
             catch(...) {
                 put_node(header);
@@ -261,6 +305,7 @@ public:
     rb_tree<Key, Value, KeyOfValue, Compare, Alloc>&
         operator=(const rb_tree<Key, Value, KeyOfValue, Compare, Alloc>& x);
 public:
+    allocator_type get_allocator() const { return rb_tree_node_allocator::policy(); }
     Compare key_comp() const { return key_compare; }
     iterator begin() { return leftmost(); }
     const_iterator begin() const { return leftmost(); }
@@ -274,16 +319,25 @@ public:
         std::swap(header, t.header);
         std::swap(node_count, t.node_count);
         std::swap(key_compare, t.key_compare);
+        std::swap(static_cast<rb_tree_node_allocator&>(*this),
+                  static_cast<rb_tree_node_allocator&>(t));
     }
 public:
     // 独一无二的插入
-    pair<iterator, bool> insert_unique(const value_type& x);
+    pair<iterator, bool> insert_unique(const value_type& x) {
+        node_creator gen(*this);
+        return _insert_unique(x, gen);
+    }
     // 可重复的插入
-    iterator insert_equal(const value_type& x);
+    iterator insert_equal(const value_type& x) {
+        node_creator gen(*this);
+        return _insert_equal(x, gen);
+    }
 
     iterator insert_unique(iterator positin, const value_type& x);
     iterator insert_equal(iterator position, const value_type& x);
 
+    // 区间插入从成批配置的节点中取用
     template<typename InputIterator>
     void insert_unique(InputIterator first, InputIterator last);
     template<typename InputIterator>
@@ -352,7 +406,7 @@ inline void _rb_tree_rotate_right(_rb_tree_node_base* x, _rb_tree_node_base*& ro
         x->parent->right = y;
     else
         x->parent->left = y;
-    x->right = x;
+    y->right = x;
     x->parent = y;
 }
 
@@ -553,7 +607,8 @@ operator=(const rb_tree<Key, Value, KeyOfValue, Compare, Alloc>& x) {
             rightmost() = header;
         }
         else {
-            root() = _copy(x.root(), header);
+            batch_node_creator gen(*this, x.node_count);
+            root() = _copy(x.root(), header, gen);
             leftmost() = minimum(root());
             rightmost() = maximum(root());
             node_count = x.node_count;
@@ -563,15 +618,16 @@ operator=(const rb_tree<Key, Value, KeyOfValue, Compare, Alloc>& x) {
 }
 
 template<typename Key, typename Value, typename KeyOfValue, typename Compare, typename Alloc>
+template<typename NodeGen>
 typename rb_tree<Key, Value, KeyOfValue, Compare, Alloc>::iterator
 rb_tree<Key, Value, KeyOfValue, Compare, Alloc>::
-_insert(base_ptr x_, base_ptr y_, const Value& v) {
+_insert(base_ptr x_, base_ptr y_, const Value& v, NodeGen& gen) {
     link_type x = (link_type) x_;
     link_type y = (link_type) y_;
     link_type z;
 
     if (y == header || x != 0 || key_compare(KeyOfValue()(v), key(y))) {
-        z = create_node(v);
+        z = gen(v);
         left(y) = z;
         if (y == header) {
             root() = z;
@@ -579,36 +635,38 @@ _insert(base_ptr x_, base_ptr y_, const Value& v) {
         }
         else if (y == leftmost())
             leftmost() = z;
-        else {
-            z = create_node(v);
-            right(y) = z;
+    }
+    else {
+        z = gen(v);
+        right(y) = z;
         if (y == rightmost())
             rightmost() = z;
-        }
-        parent(z) = y;
-        left(z) = 0;
-        right(z) = 0;
-        _rb_tree_rebalance(z, header->parent);
-        ++node_count;
-        return iterator(z);
     }
+    parent(z) = y;
+    left(z) = 0;
+    right(z) = 0;
+    _rb_tree_rebalance(z, header->parent);
+    ++node_count;
+    return iterator(z);
 }
 
 template<typename Key, typename Value, typename KeyOfValue, typename Compare, typename Alloc>
+template<typename NodeGen>
 typename rb_tree<Key, Value, KeyOfValue, Compare, Alloc>::iterator
-rb_tree<Key, Value, KeyOfValue, Compare, Alloc>::insert_equal(const Value& v) {
+rb_tree<Key, Value, KeyOfValue, Compare, Alloc>::_insert_equal(const Value& v, NodeGen& gen) {
     link_type y = header;
     link_type x = root();
     while (x != 0) {
         y = x;
         x = key_compare(KeyOfValue()(v), key(x)) ? left(x) : right(x);
     }
-    return _insert(x, y, v);
+    return _insert(x, y, v, gen);
 }
 
 template<typename Key, typename Value, typename KeyOfValue, typename Compare, typename Alloc>
+template<typename NodeGen>
 pair<typename rb_tree<Key, Value, KeyOfValue, Compare, Alloc>::iterator, bool>
-rb_tree<Key, Value, KeyOfValue, Compare, Alloc>::insert_unique(const Value& v) {
+rb_tree<Key, Value, KeyOfValue, Compare, Alloc>::_insert_unique(const Value& v, NodeGen& gen) {
     link_type y = header;
     link_type x = root();
     bool comp = true;
@@ -620,11 +678,11 @@ rb_tree<Key, Value, KeyOfValue, Compare, Alloc>::insert_unique(const Value& v) {
     iterator j = iterator(y);
     if (comp)
         if (j == begin())
-            return pair<iterator,bool>(_insert(x, y, v), true);
+            return pair<iterator,bool>(_insert(x, y, v, gen), true);
         else
             --j;
     if (key_compare(key(j.node), KeyOfValue()(v)))
-        return pair<iterator,bool>(_insert(x, y, v), true);
+        return pair<iterator,bool>(_insert(x, y, v, gen), true);
 
     return pair<iterator,bool>(j, false);
 }
@@ -688,15 +746,17 @@ rb_tree<Key, Val, KeyOfValue, Compare, Alloc>::insert_equal(iterator position,
 template<typename K, typename V, typename KoV, typename Cmp, typename Al>
 template<typename II>
 void rb_tree<K, V, KoV, Cmp, Al>::insert_equal(II first, II last) {
+    batch_node_creator gen(*this, 0);
     for ( ; first != last; ++first)
-       insert_equal(*first);
- }
+        _insert_equal(*first, gen);
+}
 
 template<typename K, typename V, typename KoV, typename Cmp, typename Al>
 template<typename II>
 void rb_tree<K, V, KoV, Cmp, Al>::insert_unique(II first, II last) {
+    batch_node_creator gen(*this, 0);
     for ( ; first != last; ++first)
-        insert_unique(*first);
+        _insert_unique(*first, gen);
 }
 
 template<typename Key, typename Value, typename KeyOfValue, typename Compare, typename Alloc>
@@ -721,22 +781,23 @@ rb_tree<Key, Value, KeyOfValue, Compare, Alloc>::erase(const Key& x) {
 }
 
 template<typename K, typename V, typename KeyOfValue, typename Compare, typename Alloc>
+template<typename NodeGen>
 typename rb_tree<K, V, KeyOfValue, Compare, Alloc>::link_type
-rb_tree<K, V, KeyOfValue, Compare, Alloc>::_copy(link_type x, link_type p) {
-    link_type top = clone_node(x);
+rb_tree<K, V, KeyOfValue, Compare, Alloc>::_copy(link_type x, link_type p, NodeGen& gen) {
+    link_type top = clone_node(x, gen);
     top->parent = p;
     try {
         if (x->right)
-            top->right = _copy(right(x), top);
+            top->right = _copy(right(x), top, gen);
             p = top;
             x = left(x);
 
         while (x != 0) {
-            link_type y = clone_node(x);
+            link_type y = clone_node(x, gen);
             p->left = y;
             y->parent = p;
             if (x->right)
-                y->right = _copy(right(x), y);
+                y->right = _copy(right(x), y, gen);
             p = y;
             x = left(x);
         }
@@ -749,11 +810,13 @@ rb_tree<K, V, KeyOfValue, Compare, Alloc>::_copy(link_type x, link_type p) {
 }
 
 template<typename Key, typename Value, typename KeyOfValue, typename Compare, typename Alloc>
-void rb_tree<Key, Value, KeyOfValue, Compare, Alloc>::_erase(link_type x) {
+void rb_tree<Key, Value, KeyOfValue, Compare, Alloc>::
+_erase(link_type x, node_batch_sink<rb_tree_node, Alloc>& sink) {
     while (x != 0) {
-        _erase(right(x));
+        _erase(right(x), sink);
         link_type y = left(x);
-        destroy_node(x);
+        destroy(&x->value);
+        sink.put(x);
         x = y;
     }
 }
@@ -0,0 +1,358 @@
+#ifndef MYSTL_RING_BUFFER_H_
+#define MYSTL_RING_BUFFER_H_
+
+#include "allocator.h"
+#include "construct.h"
+#include "iterator.h"
+
+#include <algorithm> //for min, move
+#include <cstddef> //for size_t, ptrdiff_t
+#include <iterator> //for move_iterator
+#include <memory> //for uninitialized_copy
+#include <stdexcept> //for out_of_range, length_error
+#include <type_traits> //for conditional, is_nothrow_move_constructible
+#include <utility> //for forward, move, pair, swap
+
+namespace mystl {
+
+//ring_buffer的迭代器，以不断递增的下标与掩码定位元素
+template<typename T, typename Ref, typename Ptr>
+struct _ring_iterator {
+    typedef random_access_iterator_tag  iterator_category;
+    typedef T                           value_type;
+    typedef ptrdiff_t                   difference_type;
+    typedef Ptr                         pointer;
+    typedef Ref                         reference;
+    typedef _ring_iterator              self;
+
+    T *start;
+    size_t mask;
+    size_t index; //不取模的下标，与容器的head_、tail_一致
+
+    _ring_iterator() : start(0), mask(0), index(0) {}
+    _ring_iterator(T *s, size_t m, size_t i) : start(s), mask(m), index(i) {}
+    template<typename R, typename P>
+    _ring_iterator(const _ring_iterator<T, R, P>& x) : start(x.start), mask(x.mask), index(x.index) {}
+
+    reference operator*() const { return start[index & mask]; }
+    pointer operator->() const { return &(operator*()); }
+    reference operator[](difference_type n) const { return start[(index + n) & mask]; }
+
+    self& operator++() { ++index; return *this; }
+    self operator++(int) { self tmp = *this; ++index; return tmp; }
+    self& operator--() { --index; return *this; }
+    self operator--(int) { self tmp = *this; --index; return tmp; }
+    self& operator+=(difference_type n) { index += n; return *this; }
+    self& operator-=(difference_type n) { index -= n; return *this; }
+    self operator+(difference_type n) const { return self(start, mask, index + n); }
+    self operator-(difference_type n) const { return self(start, mask, index - n); }
+    //下标回绕后差值仍然正确
+    difference_type operator-(const self& x) const {
+        return static_cast<difference_type>(index - x.index);
+    }
+
+    bool operator==(const self& x) const { return index == x.index; }
+    bool operator!=(const self& x) const { return index != x.index; }
+    bool operator<(const self& x) const { return *this - x < 0; }
+    bool operator>(const self& x) const { return x < *this; }
+    bool operator<=(const self& x) const { return !(x < *this); }
+    bool operator>=(const self& x) const { return !(*this < x); }
+};
+
+//环形缓冲区：元素存放在一块容量为2的幂的连续空间中，下标与掩码相与即得位置，
+//首尾的进出只移动下标，不配置也不释放内存
+//growable时容量不足按2倍扩容；fixed时不自动扩容，满时追加抛出length_error
+//满足queue对Sequence的要求，可作为queue的底层容器
+template<typename T, typename Alloc = alloc>
+class ring_buffer : protected allocator<T, Alloc> {
+
+public:
+    typedef T                   value_type;
+    typedef value_type*         pointer;
+    typedef const value_type*   const_pointer;
+    typedef value_type&         reference;
+    typedef const value_type&   const_reference;
+    typedef size_t              size_type;
+    typedef ptrdiff_t           difference_type;
+    typedef Alloc               allocator_type;
+    typedef _ring_iterator<T, T&, T*> iterator;
+    typedef _ring_iterator<T, const T&, const T*> const_iterator;
+
+    enum capacity_mode { growable, fixed };
+
+protected:
+    typedef allocator<T, Alloc> data_allocator;
+
+    enum { INITIAL_CAPACITY = 16 };
+
+    pointer start_;
+    size_type mask_; //容量减1，没有配置空间时为size_type(-1)
+    size_type head_; //front()的下标，只增不减，使用时与mask_相与
+    size_type tail_; //back()之后的下标，tail_ - head_即元素个数
+    bool fixed_;
+
+    //不小于n的最小的2的幂
+    static size_type round_up(size_type n) {
+        size_type c = 1;
+        while (c < n) c <<= 1;
+        return c;
+    }
+    pointer at_index(size_type i) const { return start_ + (i & mask_); }
+    //为追加n个元素保证容量，fixed时容量不足抛出length_error
+    void ensure_room(size_type n) {
+        if (n <= capacity() - size()) return;
+        if (fixed_) throw std::length_error("ring_buffer is full");
+        size_type grown = capacity() == 0 ? size_type(INITIAL_CAPACITY) : 2 * capacity();
+        reallocate(std::max(round_up(size() + n), grown));
+    }
+    void reallocate(size_type new_capacity);
+    //空间已满时的emplace_back，与常用的路径分开以便后者内联
+    template<typename... Args>
+    reference emplace_back_aux(Args&&... args);
+    //将[first1, last1)与[first2, last2)依次构造到未初始化的result处，中途抛出异常时析构已构造的元素
+    template<typename InputIterator>
+    static void construct_spans(pointer result, InputIterator first1, InputIterator last1,
+                                InputIterator first2, InputIterator last2);
+    void deallocate() {
+        if (start_) data_allocator::deallocate(start_, capacity());
+    }
+
+public:
+    //构造，析构，复制，移动相关函数
+    ring_buffer() : start_(0), mask_(size_type(-1)), head_(0), tail_(0), fixed_(false) {}
+    //容量向上取为2的幂
+    explicit ring_buffer(size_type capacity, capacity_mode mode = growable)
+        : start_(0), mask_(size_type(-1)), head_(0), tail_(0), fixed_(mode == fixed) {
+        if (capacity != 0) reallocate(round_up(capacity));
+    }
+    ring_buffer(const ring_buffer& x);
+    ring_buffer(ring_buffer&& x) : start_(0), mask_(size_type(-1)), head_(0), tail_(0), fixed_(false) {
+        swap(x);
+    }
+    ring_buffer& operator=(ring_buffer x) { //swap实现，既是拷贝也是移动赋值运算符
+        swap(x);
+        return *this;
+    }
+    ~ring_buffer() {
+        clear();
+        deallocate();
+    }
+
+    allocator_type get_allocator() const { return data_allocator::policy(); }
+
+    //比较相关操作
+    bool operator==(const ring_buffer& x) const;
+    bool operator!=(const ring_buffer& x) const { return !(*this == x); }
+    bool operator<(const ring_buffer& x) const;
+
+    //迭代器和容量相关
+    iterator begin() { return iterator(start_, mask_, head_); }
+    const_iterator begin() const { return const_iterator(start_, mask_, head_); }
+    const_iterator cbegin() const { return begin(); }
+    iterator end() { return iterator(start_, mask_, tail_); }
+    const_iterator end() const { return const_iterator(start_, mask_, tail_); }
+    const_iterator cend() const { return end(); }
+    size_type size() const { return tail_ - head_; }
+    size_type capacity() const { return mask_ + 1; }
+    bool empty() const { return head_ == tail_; }
+    bool full() const { return size() == capacity(); }
+    capacity_mode mode() const { return fixed_ ? fixed : growable; }
+    //容量扩至不小于n的2的幂，fixed时也可显式扩容
+    void reserve(size_type n) {
+        if (n > capacity()) reallocate(round_up(n));
+    }
+
+    //访问元素相关
+    reference operator[](size_type n) { return *at_index(head_ + n); }
+    const_reference operator[](size_type n) const { return *at_index(head_ + n); }
+    reference at(size_type n) {
+        if (n >= size()) throw std::out_of_range("ring_buffer::at");
+        return (*this)[n];
+    }
+    const_reference at(size_type n) const {
+        if (n >= size()) throw std::out_of_range("ring_buffer::at");
+        return (*this)[n];
+    }
+    reference front() { return *at_index(head_); }
+    const_reference front() const { return *at_index(head_); }
+    reference back() { return *at_index(tail_ - 1); }
+    const_reference back() const { return *at_index(tail_ - 1); }
+    //元素在空间中至多分为两段连续的区间，array_one()为从front()开始的一段，array_two()为回绕后的一段
+    std::pair<pointer, size_type> array_one() const {
+        size_type pos = head_ & mask_;
+        return std::make_pair(start_ + pos, std::min(size(), capacity() - pos));
+    }
+    std::pair<pointer, size_type> array_two() const {
+        return std::make_pair(start_, size() - array_one().second);
+    }
+
+    //操作容器相关
+    template<typename... Args>
+    reference emplace_back(Args&&... args) {
+        if (full()) return emplace_back_aux(std::forward<Args>(args)...);
+        construct(at_index(tail_), std::forward<Args>(args)...);
+        ++tail_;
+        return back();
+    }
+    void push_back(const value_type& value) { emplace_back(value); }
+    void push_back(value_type&& value) { emplace_back(std::move(value)); }
+    void pop_front() {
+        destroy(at_index(head_));
+        ++head_;
+    }
+    void pop_back() {
+        --tail_;
+        destroy(at_index(tail_));
+    }
+    //在尾端追加[first, first + n)，至多复制两段连续区间；first不能指向本容器的元素
+    void push_back_n(const_pointer first, size_type n);
+    //将前端n个元素依次移动到result处并移除，返回result + n；n不能大于size()
+    pointer pop_front_n(pointer result, size_type n);
+    //移除前端n个元素；n不能大于size()
+    void pop_front(size_type n);
+    void clear() {
+        pop_front(size());
+        head_ = tail_ = 0;
+    }
+    void swap(ring_buffer& x);
+};
+
+template<typename T, typename Alloc>
+template<typename InputIterator>
+void ring_buffer<T, Alloc>::construct_spans(pointer result, InputIterator first1, InputIterator last1,
+                                            InputIterator first2, InputIterator last2) {
+    pointer mid = std::uninitialized_copy(first1, last1, result);
+    try {
+        std::uninitialized_copy(first2, last2, mid);
+    } catch(...) {
+        destroy(result, mid);
+        throw;
+    }
+}
+
+//元素移到新空间的开头，移动构造可能抛出异常且可复制时改为复制，保证失败时原有元素不变
+template<typename T, typename Alloc>
+void ring_buffer<T, Alloc>::reallocate(size_type new_capacity) {
+    typedef typename std::conditional<!std::is_nothrow_move_constructible<T>::value
+        && std::is_copy_constructible<T>::value, const T*, std::move_iterator<T*> >::type source;
+    pointer new_start = data_allocator::allocate(new_capacity);
+    std::pair<pointer, size_type> one = array_one(), two = array_two();
+    try {
+        construct_spans(new_start, source(one.first), source(one.first + one.second),
+                        source(two.first), source(two.first + two.second));
+    } catch(...) {
+        data_allocator::deallocate(new_start, new_capacity);
+        throw;
+    }
+    size_type n = size();
+    clear();
+    deallocate();
+    start_ = new_start;
+    mask_ = new_capacity - 1;
+    head_ = 0;
+    tail_ = n;
+}
+
+template<typename T, typename Alloc>
+ring_buffer<T, Alloc>::ring_buffer(const ring_buffer& x)
+    : data_allocator(x.policy()), start_(0), mask_(size_type(-1)), head_(0), tail_(0),
+      fixed_(x.fixed_) {
+    if (x.capacity() == 0) return;
+    start_ = data_allocator::allocate(x.capacity());
+    mask_ = x.mask_;
+    std::pair<pointer, size_type> one = x.array_one(), two = x.array_two();
+    try {
+        construct_spans<const_pointer>(start_, one.first, one.first + one.second,
+                                       two.first, two.first + two.second);
+    } catch(...) {
+        deallocate();
+        throw;
+    }
+    tail_ = x.size();
+}
+
+//先在临时对象中构造元素，args引用本容器的元素时扩容后仍然正确
+template<typename T, typename Alloc>
+template<typename... Args>
+typename ring_buffer<T, Alloc>::reference ring_buffer<T, Alloc>::emplace_back_aux(Args&&... args) {
+    if (fixed_) throw std::length_error("ring_buffer is full");
+    value_type tmp(std::forward<Args>(args)...);
+    ensure_room(1);
+    construct(at_index(tail_), std::move(tmp));
+    ++tail_;
+    return back();
+}
+
+template<typename T, typename Alloc>
+void ring_buffer<T, Alloc>::push_back_n(const_pointer first, size_type n) {
+    ensure_room(n);
+    pointer pos = at_index(tail_);
+    size_type k = std::min(n, static_cast<size_type>(start_ + capacity() - pos));
+    std::uninitialized_copy(first, first + k, pos);
+    try {
+        std::uninitialized_copy(first + k, first + n, start_);
+    } catch(...) {
+        destroy(pos, pos + k);
+        throw;
+    }
+    tail_ += n;
+}
+
+template<typename T, typename Alloc>
+typename ring_buffer<T, Alloc>::pointer ring_buffer<T, Alloc>::pop_front_n(pointer result, size_type n) {
+    pointer pos = at_index(head_);
+    size_type k = std::min(n, static_cast<size_type>(start_ + capacity() - pos));
+    result = std::move(pos, pos + k, result);
+    result = std::move(start_, start_ + (n - k), result);
+    pop_front(n);
+    return result;
+}
+
+template<typename T, typename Alloc>
+void ring_buffer<T, Alloc>::pop_front(size_type n) {
+    if (n == 0) return;
+    pointer pos = at_index(head_);
+    size_type k = std::min(n, static_cast<size_type>(start_ + capacity() - pos));
+    destroy(pos, pos + k);
+    destroy(start_, start_ + (n - k));
+    head_ += n;
+}
+
+template<typename T, typename Alloc>
+bool ring_buffer<T, Alloc>::operator==(const ring_buffer& x) const {
+    if (size() != x.size()) return false;
+    for (size_type i = 0; i != size(); ++i) {
+        if (!((*this)[i] == x[i])) return false;
+    }
+    return true;
+}
+
+template<typename T, typename Alloc>
+bool ring_buffer<T, Alloc>::operator<(const ring_buffer& x) const {
+    size_type n = std::min(size(), x.size());
+    for (size_type i = 0; i != n; ++i) {
+        if ((*this)[i] < x[i]) return true;
+        if (x[i] < (*this)[i]) return false;
+    }
+    return size() < x.size();
+}
+
+template<typename T, typename Alloc>
+void ring_buffer<T, Alloc>::swap(ring_buffer& x) {
+    using std::swap;
+    swap(start_, x.start_);
+    swap(mask_, x.mask_);
+    swap(head_, x.head_);
+    swap(tail_, x.tail_);
+    swap(fixed_, x.fixed_);
+    swap(static_cast<data_allocator&>(*this), static_cast<data_allocator&>(x)); //配置器随内存交换
+}
+
+template<typename T, typename Alloc>
+inline void swap(ring_buffer<T, Alloc>& x, ring_buffer<T, Alloc>& y) {
+    x.swap(y);
+}
+
+} //namespace mystl
+
+#endif
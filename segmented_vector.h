@@ -0,0 +1,292 @@
+#ifndef MYSTL_SEGMENTED_VECTOR_H_
+#define MYSTL_SEGMENTED_VECTOR_H_
+
+#include "allocator.h"
+#include "construct.h"
+#include "iterator.h"
+
+#include <algorithm> //for min
+#include <cstddef> //for size_t, ptrdiff_t
+#include <initializer_list> //for initializer_list
+#include <memory> //for uninitialized_copy
+#include <stdexcept> //for out_of_range
+#include <utility> //for forward, move, swap
+
+namespace mystl {
+
+//segmented_vector的迭代器，以下标定位元素，与容器一样可随机访问
+template<typename T, typename Ref, typename Ptr, typename Vec>
+struct _segmented_iterator {
+    typedef random_access_iterator_tag  iterator_category;
+    typedef T                           value_type;
+    typedef ptrdiff_t                   difference_type;
+    typedef Ptr                         pointer;
+    typedef Ref                         reference;
+    typedef _segmented_iterator         self;
+
+    Vec *vec;
+    size_t index;
+
+    _segmented_iterator() : vec(0), index(0) {}
+    _segmented_iterator(Vec *v, size_t i) : vec(v), index(i) {}
+    template<typename R, typename P, typename V>
+    _segmented_iterator(const _segmented_iterator<T, R, P, V>& x) : vec(x.vec), index(x.index) {}
+
+    reference operator*() const { return (*vec)[index]; }
+    pointer operator->() const { return &(operator*()); }
+    reference operator[](difference_type n) const { return (*vec)[index + n]; }
+
+    self& operator++() { ++index; return *this; }
+    self operator++(int) { self tmp = *this; ++index; return tmp; }
+    self& operator--() { --index; return *this; }
+    self operator--(int) { self tmp = *this; --index; return tmp; }
+    self& operator+=(difference_type n) { index += n; return *this; }
+    self& operator-=(difference_type n) { index -= n; return *this; }
+    self operator+(difference_type n) const { return self(vec, index + n); }
+    self operator-(difference_type n) const { return self(vec, index - n); }
+    difference_type operator-(const self& x) const {
+        return static_cast<difference_type>(index) - static_cast<difference_type>(x.index);
+    }
+
+    bool operator==(const self& x) const { return index == x.index; }
+    bool operator!=(const self& x) const { return index != x.index; }
+    bool operator<(const self& x) const { return index < x.index; }
+    bool operator>(const self& x) const { return index > x.index; }
+    bool operator<=(const self& x) const { return index <= x.index; }
+    bool operator>=(const self& x) const { return index >= x.index; }
+};
+
+//分段存储的vector：元素存放在一组区块中，第k块可容纳FIRST_SIZE << k个元素，
+//扩容时只配置新的区块，已有元素从不搬移，指向元素的指针与引用在元素被删除前一直有效
+//区块指针存放在定长数组中，下标经一次前导零计数即可换算为区块与块内偏移
+template<typename T, typename Alloc = alloc>
+class segmented_vector : protected allocator<T, Alloc> {
+
+public:
+    typedef T                   value_type;
+    typedef value_type*         pointer;
+    typedef const value_type*   const_pointer;
+    typedef value_type&         reference;
+    typedef const value_type&   const_reference;
+    typedef size_t              size_type;
+    typedef ptrdiff_t           difference_type;
+    typedef Alloc               allocator_type;
+    typedef _segmented_iterator<T, T&, T*, segmented_vector> iterator;
+    typedef _segmented_iterator<T, const T&, const T*, const segmented_vector> const_iterator;
+
+protected:
+    typedef allocator<T, Alloc> data_allocator;
+
+    enum { FIRST_SHIFT = 4 };
+    enum { FIRST_SIZE = 1 << FIRST_SHIFT }; //第0块的元素个数
+    enum { MAX_BLOCKS = int(sizeof(size_t) * 8) - FIRST_SHIFT };
+
+    pointer blocks_[MAX_BLOCKS]; //第k块的首地址，构造时全部置空，swap可以交换任意一块
+    size_type block_count_; //已配置的区块数
+    size_type size_;
+
+    static size_type block_size(size_type k) { return size_type(FIRST_SIZE) << k; }
+    //前k块的总容量
+    static size_type blocks_capacity(size_type k) {
+        return (size_type(FIRST_SIZE) << k) - FIRST_SIZE;
+    }
+    //第n个元素所在的区块
+    static size_type block_of(size_type n) {
+        return (sizeof(size_type) * 8 - 1) - __builtin_clzl(n + FIRST_SIZE) - FIRST_SHIFT;
+    }
+    pointer locate(size_type n) const {
+        size_type k = block_of(n);
+        return blocks_[k] + (n - blocks_capacity(k));
+    }
+    //配置下一块
+    void add_block() {
+        blocks_[block_count_] = data_allocator::allocate(block_size(block_count_));
+        ++block_count_;
+    }
+    //析构[n, size())的元素
+    void destroy_from(size_type n);
+    //释放第k块之后（含）的空闲区块
+    void release_blocks(size_type k);
+    //析构全部元素并释放全部区块
+    void release_all() {
+        clear();
+        release_blocks(0);
+    }
+    void copy_from(const segmented_vector& x);
+
+public:
+    //构造，析构，复制，移动相关函数
+    segmented_vector() : blocks_(), block_count_(0), size_(0) {}
+    explicit segmented_vector(const allocator_type& a)
+        : data_allocator(a), blocks_(), block_count_(0), size_(0) {}
+    //构造函数中途抛出异常时析构函数不会执行，由构造函数自行析构已构造的元素并释放区块
+    segmented_vector(size_type n, const value_type& value) : blocks_(), block_count_(0), size_(0) {
+        try {
+            resize(n, value);
+        } catch(...) {
+            release_all();
+            throw;
+        }
+    }
+    explicit segmented_vector(size_type n) : blocks_(), block_count_(0), size_(0) {
+        try {
+            resize(n);
+        } catch(...) {
+            release_all();
+            throw;
+        }
+    }
+    segmented_vector(std::initializer_list<value_type> values) : blocks_(), block_count_(0), size_(0) {
+        try {
+            reserve(values.size());
+            for (const value_type& v : values) push_back(v);
+        } catch(...) {
+            release_all();
+            throw;
+        }
+    }
+    segmented_vector(const segmented_vector& x)
+        : data_allocator(x.policy()), blocks_(), block_count_(0), size_(0) { copy_from(x); }
+    segmented_vector(segmented_vector&& x) : blocks_(), block_count_(0), size_(0) { swap(x); }
+    segmented_vector& operator=(segmented_vector x) { //swap实现，既是拷贝也是移动赋值运算符
+        swap(x);
+        return *this;
+    }
+    ~segmented_vector() { release_all(); }
+
+    allocator_type get_allocator() const { return data_allocator::policy(); }
+
+    //比较相关操作
+    bool operator==(const segmented_vector& x) const;
+    bool operator!=(const segmented_vector& x) const { return !(*this == x); }
+
+    //迭代器和容量相关
+    iterator begin() { return iterator(this, 0); }
+    const_iterator begin() const { return const_iterator(this, 0); }
+    const_iterator cbegin() const { return begin(); }
+    iterator end() { return iterator(this, size_); }
+    const_iterator end() const { return const_iterator(this, size_); }
+    const_iterator cend() const { return end(); }
+    size_type size() const { return size_; }
+    size_type capacity() const { return blocks_capacity(block_count_); }
+    bool empty() const { return size_ == 0; }
+    //按需配置区块直至容量不小于n，不搬移已有元素
+    void reserve(size_type n) {
+        while (capacity() < n) add_block();
+    }
+    void resize(size_type n) { resize(n, T()); }
+    void resize(size_type n, const value_type& value);
+    //释放没有元素的区块
+    void shrink_to_fit() { release_blocks(size_ == 0 ? 0 : block_of(size_ - 1) + 1); }
+
+    //访问元素相关
+    reference operator[](size_type n) { return *locate(n); }
+    const_reference operator[](size_type n) const { return *locate(n); }
+    reference at(size_type n) {
+        if (n >= size_) throw std::out_of_range("segmented_vector::at");
+        return *locate(n);
+    }
+    const_reference at(size_type n) const {
+        if (n >= size_) throw std::out_of_range("segmented_vector::at");
+        return *locate(n);
+    }
+    reference front() { return *blocks_[0]; }
+    const_reference front() const { return *blocks_[0]; }
+    reference back() { return *locate(size_ - 1); }
+    const_reference back() const { return *locate(size_ - 1); }
+
+    //操作容器相关
+    template<typename... Args>
+    reference emplace_back(Args&&... args) {
+        if (size_ == capacity()) add_block();
+        pointer p = locate(size_);
+        construct(p, std::forward<Args>(args)...);
+        ++size_;
+        return *p;
+    }
+    void push_back(const value_type& value) { emplace_back(value); }
+    void push_back(value_type&& value) { emplace_back(std::move(value)); }
+    void pop_back() {
+        --size_;
+        destroy(locate(size_));
+    }
+    void clear() {
+        destroy_from(0);
+        size_ = 0;
+    }
+    void swap(segmented_vector& x);
+};
+
+template<typename T, typename Alloc>
+void segmented_vector<T, Alloc>::destroy_from(size_type n) {
+    while (n < size_) {
+        size_type k = block_of(n);
+        size_type last = std::min(size_, blocks_capacity(k + 1));
+        destroy(blocks_[k] + (n - blocks_capacity(k)), blocks_[k] + (last - blocks_capacity(k)));
+        n = last;
+    }
+}
+
+template<typename T, typename Alloc>
+void segmented_vector<T, Alloc>::release_blocks(size_type k) {
+    while (block_count_ > k) {
+        --block_count_;
+        data_allocator::deallocate(blocks_[block_count_], block_size(block_count_));
+    }
+}
+
+//逐块复制，配置区块或复制中途抛出异常时析构已复制的元素并释放全部区块
+template<typename T, typename Alloc>
+void segmented_vector<T, Alloc>::copy_from(const segmented_vector& x) {
+    try {
+        reserve(x.size_);
+        for (size_type k = 0; size_ < x.size_; ++k) {
+            size_type n = std::min(x.size_, blocks_capacity(k + 1)) - size_;
+            std::uninitialized_copy(x.blocks_[k], x.blocks_[k] + n, blocks_[k]);
+            size_ += n;
+        }
+    } catch(...) {
+        release_all();
+        throw;
+    }
+}
+
+template<typename T, typename Alloc>
+void segmented_vector<T, Alloc>::resize(size_type n, const value_type& value) {
+    if (n <= size_) {
+        destroy_from(n);
+        size_ = n;
+        return;
+    }
+    reserve(n);
+    while (size_ < n) emplace_back(value); //已有元素不会搬移，value引用自身元素时仍然有效
+}
+
+template<typename T, typename Alloc>
+bool segmented_vector<T, Alloc>::operator==(const segmented_vector& x) const {
+    if (size_ != x.size_) return false;
+    for (size_type i = 0; i != size_; ++i) {
+        if (!((*this)[i] == x[i])) return false;
+    }
+    return true;
+}
+
+template<typename T, typename Alloc>
+void segmented_vector<T, Alloc>::swap(segmented_vector& x) {
+    using std::swap;
+    for (size_type k = 0; k != MAX_BLOCKS; ++k) {
+        if (k < block_count_ || k < x.block_count_) swap(blocks_[k], x.blocks_[k]);
+    }
+    swap(block_count_, x.block_count_);
+    swap(size_, x.size_);
+    swap(static_cast<data_allocator&>(*this), static_cast<data_allocator&>(x)); //配置器随内存交换
+}
+
+template<typename T, typename Alloc>
+inline void swap(segmented_vector<T, Alloc>& x, segmented_vector<T, Alloc>& y) {
+    x.swap(y);
+}
+
+} //namespace mystl
+
+#endif
@@ -44,9 +44,11 @@ public:
     typedef typename rep_type::const_iterator const_iterator;
     typedef typename rep_type::size_type size_type;
     typedef typename rep_type::difference_type difference_type;  // STL标准强制要求
+    typedef typename rep_type::allocator_type allocator_type;
 
     set() : t(Compare()) {}
     explicit set(const Compare& comp) : t(comp) {}
+    set(const Compare& comp, const allocator_type& a) : t(comp, a) {}
 
     template<typename InputIterator>
     set(InputIterator first, InputIterator last)
@@ -63,6 +65,7 @@ public:
         return *this;
     }
 
+    allocator_type get_allocator() const { return t.get_allocator(); }
     key_compare key_comp() const { return t.key_comp(); }
     value_compare value_comp() const { return t.key_comp(); }
 
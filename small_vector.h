@@ -0,0 +1,257 @@
+#ifndef MYSTL_SMALL_VECTOR_H_
+#define MYSTL_SMALL_VECTOR_H_
+
+#include "allocator.h"
+#include "vector.h"
+
+#include <algorithm> //for max, swap_ranges
+#include <cstddef> //for size_t
+#include <cstring> //for memcpy
+#include <initializer_list> //for initializer_list
+#include <iostream> //for ostream
+#include <utility> //for move, swap
+
+namespace mystl {
+
+//在对象内部带有Bytes字节缓冲区的配置策略，缓冲区按Align对齐
+//缓冲区空闲且容纳得下时直接返回缓冲区，否则交给Alloc；缓冲区同一时刻只分给一个区块
+//复制与赋值只涉及Alloc，缓冲区始终属于各自的对象
+template<size_t Bytes, size_t Align, typename Alloc = alloc>
+class inline_alloc : private Alloc {
+    static_assert(Bytes != 0, "inline buffer must not be empty");
+public:
+    inline_alloc() : in_use(false) {}
+    inline_alloc(const Alloc& a) : Alloc(a), in_use(false) {}
+    inline_alloc(const inline_alloc& x) : Alloc(x.policy()), in_use(false) {}
+    inline_alloc& operator=(const inline_alloc& x) {
+        base() = x.policy();
+        return *this;
+    }
+
+    void *allocate(size_t n) {
+        if (fits(n)) return take_buffer();
+        return base().allocate(n);
+    }
+    void deallocate(void *p, size_t n) {
+        if (owns(p)) in_use = false;
+        else base().deallocate(p, n);
+    }
+    //取得缓冲区时count为缓冲区可容纳的个数
+    void *allocate_at_least(size_t n, size_t size, size_t& count) {
+        if (fits(n * size)) {
+            count = Bytes / size;
+            return take_buffer();
+        }
+        return policy_allocate_at_least(base(), n, size, count);
+    }
+    //在缓冲区与Alloc的区块之间按需搬移内容，都在Alloc中时交给Alloc调整
+    void *reallocate(void *p, size_t old_sz, size_t new_sz) {
+        if (owns(p)) {
+            if (new_sz <= Bytes) return p;
+            void *result = base().allocate(new_sz);
+            memcpy(result, p, old_sz);
+            in_use = false;
+            return result;
+        }
+        if (fits(new_sz)) {
+            memcpy(buffer, p, old_sz < new_sz ? old_sz : new_sz);
+            base().deallocate(p, old_sz);
+            return take_buffer();
+        }
+        return policy_reallocate(base(), p, old_sz, new_sz);
+    }
+    void *allocate_aligned(size_t n, size_t align) {
+        if (align <= Align && fits(n)) return take_buffer();
+        return aligned_allocate(base(), n, align);
+    }
+    void deallocate_aligned(void *p, size_t n, size_t align) {
+        if (owns(p)) in_use = false;
+        else aligned_deallocate(base(), p, n, align);
+    }
+
+    //p是否指向本对象的缓冲区
+    bool owns(const void *p) const { return p == static_cast<const void *>(buffer); }
+    //取得被包装的配置策略对象
+    const Alloc& policy() const { return *this; }
+private:
+    Alloc& base() { return *this; }
+    bool fits(size_t n) const { return !in_use && n <= Bytes; }
+    void *take_buffer() {
+        in_use = true;
+        return buffer;
+    }
+
+    alignas(Align) char buffer[Bytes];
+    bool in_use;
+};
+
+//前N个元素存放在对象内部的vector，超过N个时才从Alloc配置，其余接口与vector相同
+//元素较少的临时容器（如每个请求中的几个元素）因此不需要配置内存
+//元素位于内部缓冲区时，移动与swap逐个搬移元素，指向元素的迭代器随之失效
+//以protected方式继承vector：vector的swap、shrink_to_fit与赋值直接交换指针，
+//会把指向内部缓冲区的指针交给另一个对象，因此不允许经vector的引用调用，只公开安全的接口
+template<typename T, size_t N, typename Alloc = alloc>
+class small_vector : protected vector<T, inline_alloc<sizeof(T) * N, alignof(T), Alloc> > {
+public:
+    typedef vector<T, inline_alloc<sizeof(T) * N, alignof(T), Alloc> > base_type;
+    typedef typename base_type::value_type      value_type;
+    typedef typename base_type::pointer         pointer;
+    typedef typename base_type::const_pointer   const_pointer;
+    typedef typename base_type::iterator        iterator;
+    typedef typename base_type::const_iterator  const_iterator;
+    typedef typename base_type::reference       reference;
+    typedef typename base_type::const_reference const_reference;
+    typedef typename base_type::size_type       size_type;
+    typedef typename base_type::difference_type difference_type;
+    typedef typename base_type::allocator_type  allocator_type;
+    enum { INLINE_CAPACITY = N };
+
+    using base_type::get_allocator;
+    using base_type::begin;
+    using base_type::cbegin;
+    using base_type::end;
+    using base_type::cend;
+    using base_type::size;
+    using base_type::capacity;
+    using base_type::empty;
+    using base_type::resize;
+    using base_type::resize_default_init;
+    using base_type::reserve;
+    using base_type::operator[];
+    using base_type::at;
+    using base_type::front;
+    using base_type::back;
+    using base_type::data;
+    using base_type::clear;
+    using base_type::push_back;
+    using base_type::emplace_back;
+    using base_type::pop_back;
+    using base_type::emplace;
+    using base_type::insert;
+    using base_type::erase;
+    using base_type::assign;
+public:
+    small_vector() { this->reserve(N); }
+    explicit small_vector(const Alloc& a) : base_type(allocator_type(a)) { this->reserve(N); }
+    small_vector(size_type n, const value_type& value) {
+        this->reserve(std::max(n, size_type(N)));
+        for ( ; n > 0; --n) this->push_back(value);
+    }
+    small_vector(std::initializer_list<value_type> values) {
+        this->reserve(std::max(values.size(), size_type(N)));
+        for (const value_type& value : values) this->push_back(value);
+    }
+    small_vector(const small_vector& x) : base_type(x.get_allocator()) {
+        this->reserve(std::max(x.size(), size_type(N)));
+        for (const_iterator it = x.begin(); it != x.end(); ++it) this->push_back(*it);
+    }
+    //x的元素在Alloc的区块中时接管其区块，否则逐个移动到本对象的缓冲区
+    small_vector(small_vector&& x) : base_type(x.get_allocator()) {
+        if (x.is_inline()) {
+            this->reserve(N);
+            move_elements_from(x);
+        } else {
+            base_type::swap(x);
+        }
+    }
+    small_vector& operator=(const small_vector& x) {
+        if (this != &x) {
+            small_vector tmp(x);
+            swap(tmp);
+        }
+        return *this;
+    }
+    small_vector& operator=(small_vector&& x) {
+        if (this != &x) {
+            small_vector tmp(std::move(x));
+            swap(tmp);
+        }
+        return *this;
+    }
+
+    bool operator==(const small_vector& x) const { return base_type::operator==(x); }
+    bool operator!=(const small_vector& x) const { return base_type::operator!=(x); }
+
+    //元素是否位于对象内部的缓冲区
+    bool is_inline() const { return this->policy().owns(this->start_); }
+
+    void swap(small_vector& x);
+    //元素不超过N个时搬回内部缓冲区，否则重新配置刚好的空间
+    void shrink_to_fit();
+
+private:
+    //将x的元素逐个移动到尾部，之后清空x
+    void move_elements_from(small_vector& x) {
+        for (iterator it = x.begin(); it != x.end(); ++it) this->push_back(std::move(*it));
+        x.clear();
+    }
+
+public:
+    //重载输出运算符
+    friend std::ostream& operator<<(std::ostream &os, const small_vector& vec) {
+        for (const_iterator first = vec.begin(); first != vec.end(); ++first) {
+            os << *first << " ";
+        }
+        return os;
+    }
+};
+
+template<typename T, size_t N, typename Alloc>
+void small_vector<T, N, Alloc>::swap(small_vector& x) {
+    if (this == &x) return;
+    if (!is_inline() && !x.is_inline()) { //都在Alloc的区块中，交换指针即可
+        base_type::swap(x);
+        return;
+    }
+    if (is_inline() && x.is_inline()) { //都在缓冲区中，交换公共部分后搬移较长一方多出的元素
+        small_vector& longer = this->size() >= x.size() ? *this : x;
+        small_vector& shorter = this->size() >= x.size() ? x : *this;
+        size_type common = shorter.size();
+        std::swap_ranges(shorter.begin(), shorter.end(), longer.begin());
+        for (iterator it = longer.begin() + common; it != longer.end(); ++it)
+            shorter.push_back(std::move(*it));
+        longer.erase(longer.begin() + common, longer.end());
+        return;
+    }
+    //一方在缓冲区中：其元素移入另一方的缓冲区，另一方的区块交给它
+    small_vector& inl = is_inline() ? *this : x;
+    small_vector& heap = is_inline() ? x : *this;
+    iterator start = heap.start_, finish = heap.finish_, end_of_storage = heap.end_of_storage_;
+    heap.start_ = heap.finish_ = heap.end_of_storage_ = 0;
+    try {
+        heap.reserve(N);
+        heap.move_elements_from(inl);
+    } catch(...) {
+        heap.clear();
+        heap.deallocate();
+        heap.start_ = start;
+        heap.finish_ = finish;
+        heap.end_of_storage_ = end_of_storage;
+        throw;
+    }
+    inl.deallocate(); //归还缓冲区
+    inl.start_ = start;
+    inl.finish_ = finish;
+    inl.end_of_storage_ = end_of_storage;
+    using std::swap;
+    swap(static_cast<typename base_type::data_allocator&>(inl),
+         static_cast<typename base_type::data_allocator&>(heap)); //Alloc随区块交换
+}
+
+template<typename T, size_t N, typename Alloc>
+void small_vector<T, N, Alloc>::shrink_to_fit() {
+    if (is_inline() || this->size() == this->capacity()) return;
+    small_vector tmp(this->get_allocator().policy());
+    tmp.reserve(this->size());
+    tmp.move_elements_from(*this);
+    swap(tmp);
+}
+
+template<typename T, size_t N, typename Alloc>
+inline void swap(small_vector<T, N, Alloc>& x, small_vector<T, N, Alloc>& y) {
+    x.swap(y);
+}
+
+}//namespace mystl
+
+#endif
@@ -4,6 +4,7 @@
 #include "allocator.h"
 #include "construct.h"
 #include "pair.h"
+#include "typetraits.h"
 #include "iterator.h"
 
 #include <cstddef>
@@ -15,7 +16,8 @@
 
 namespace mystl {
 
-class string {
+//string固定使用alloc，私有继承其空间配置器以便以成员方式调用，不增加string的大小
+class string : private mystl::allocator<char, mystl::alloc> {
 public:
     typedef char            value_type;
     typedef char*           iterator;
@@ -30,7 +32,7 @@ protected:
     char* finish_;
     char* end_of_storage_;
 
-    typedef mystl::allocator<char, alloc>      data_allocator;
+    typedef mystl::allocator<char, mystl::alloc>      data_allocator;
 public:
     // 构造，复制，析构相关
     string() : start_(0), finish_(0), end_of_storage_(0) {}
@@ -65,10 +67,13 @@ public:
 
     void resize(size_type n);
     void resize(size_type n, char c);
+    //新增的字符不初始化，供随后整体覆盖的缓冲区（如read的目标）使用
+    void resize_default_init(size_type n);
     void reserve(size_type n = 0);
-    void shrink_to_fit() {
-        data_allocator::deallocate(finish_, end_of_storage_ - finish_);
-        end_of_storage_ = finish_;
+    void shrink_to_fit() { // 内存池按整块回收，不能只归还尾部，重新分配一块刚好的空间
+        if (finish_ == end_of_storage_) return;
+        string tmp(*this);
+        swap(tmp);
     }
     void clear() {
         destroy(start_, finish_);
@@ -231,6 +236,12 @@ public:
     friend std::istream& getline(std::istream& is, string& str);
 }; // class string
 
+//string只保存指向堆上字符的指针，按字节搬移即可完成重定位
+template<>
+struct _relocate_traits<string> {
+    typedef _true_type is_trivially_relocatable;
+};
+
 template<typename InputIterator>
 string::string(InputIterator first, InputIterator last) {
     // 处理指针和数字间区别的函数
@@ -244,8 +255,8 @@ string::insert_copy_aux(iterator p, InputIterator first, InputIterator last) {
     size_type old_capacity = capacity();
     auto res = std::max(old_capacity, len_insert);
     // 新的容量分配
-    auto new_capacity = old_capacity + res;
-    iterator new_start_ = data_allocator::allocate(new_capacity);
+    size_type new_capacity = old_capacity + res;
+    iterator new_start_ = data_allocator::allocate_at_least(new_capacity, new_capacity);
     iterator new_finish_ = std::uninitialized_copy(start_, p, new_start_);
     new_finish_ = std::uninitialized_copy(first, last, new_finish_);
     auto tmp = new_finish_;
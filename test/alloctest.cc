@@ -0,0 +1,477 @@
+#include "alloctest.h"
+
+namespace mystl{
+namespace alloctest{
+
+// 单线程：各种大小的区块分配、写入、释放后可被复用
+void testCase1(){
+    std::vector<void*> blocks;
+    for (size_t n = 1; n <= 256; ++n) {
+        void *p = alloc::allocate(n);
+        assert(p != 0);
+        memset(p, static_cast<int>(n), n);
+        blocks.push_back(p);
+    }
+    for (size_t n = 1; n <= 256; ++n) {
+        unsigned char *p = static_cast<unsigned char*>(blocks[n - 1]);
+        assert(p[0] == static_cast<unsigned char>(n) && p[n - 1] == p[0]);
+        alloc::deallocate(p, n);
+    }
+
+    void *p1 = alloc::allocate(24);
+    alloc::deallocate(p1, 24);
+    void *p2 = alloc::allocate(24);
+    assert(p1 == p2); // 线程缓存后进先出
+    alloc::deallocate(p2, 24);
+}
+
+// 多线程：每个线程独立使用基于内存池的容器
+void testCase2(){
+    std::vector<std::thread> workers;
+    for (int t = 0; t != 4; ++t) {
+        workers.push_back(std::thread([t]() {
+            for (int round = 0; round != 50; ++round) {
+                mystl::list<int> lst;
+                for (int i = 0; i != 1000; ++i)
+                    lst.push_back(i + t);
+                int expect = t;
+                for (auto it = lst.begin(); it != lst.end(); ++it, ++expect)
+                    assert(*it == expect);
+            }
+        }));
+    }
+    for (auto& w : workers) w.join();
+}
+
+// 多线程：生产者分配，消费者释放
+void testCase3(){
+    std::mutex mtx;
+    std::vector<void*> queue;
+    bool done = false;
+    std::thread producer([&]() {
+        for (int i = 0; i != 100000; ++i) {
+            void *p = alloc::allocate(32);
+            memset(p, 0x5a, 32);
+            std::lock_guard<std::mutex> lock(mtx);
+            queue.push_back(p);
+        }
+        std::lock_guard<std::mutex> lock(mtx);
+        done = true;
+    });
+    std::thread consumer([&]() {
+        for (;;) {
+            std::vector<void*> batch;
+            bool finished;
+            {
+                std::lock_guard<std::mutex> lock(mtx);
+                batch.swap(queue);
+                finished = done;
+            }
+            for (void *p : batch) {
+                assert(static_cast<unsigned char*>(p)[31] == 0x5a);
+                alloc::deallocate(p, 32);
+            }
+            if (finished && batch.empty()) break;
+        }
+    });
+    producer.join();
+    consumer.join();
+}
+
+// 中型区块（128字节到32K）走内存池，超过32K走第一级配置器
+void testCase4(){
+    std::vector<std::pair<void*, size_t>> blocks;
+    for (size_t n = 129; n <= 40 * 1024; n = n * 5 / 4 + 3) {
+        for (int i = 0; i != 5; ++i) {
+            void *p = alloc::allocate(n);
+            memset(p, static_cast<int>(n & 0xff), n);
+            blocks.push_back(std::make_pair(p, n));
+        }
+    }
+    for (auto& b : blocks) {
+        unsigned char *p = static_cast<unsigned char*>(b.first);
+        assert(p[0] == (b.second & 0xff) && p[b.second - 1] == p[0]);
+        alloc::deallocate(b.first, b.second);
+    }
+
+    void *p1 = alloc::allocate(500);
+    alloc::deallocate(p1, 500);
+    void *p2 = alloc::allocate(512); // 500与512属于同一级别
+    assert(p1 == p2);
+    alloc::deallocate(p2, 512);
+}
+
+// 完全空闲的chunk可由trim归还系统
+void testCase5(){
+    alloc::set_trim_threshold(0); // 关闭自动trim，由本用例显式调用
+    std::vector<void*> blocks;
+    for (int i = 0; i != 100000; ++i) {
+        blocks.push_back(alloc::allocate(64));
+    }
+    for (void *p : blocks) {
+        alloc::deallocate(p, 64);
+    }
+    assert(alloc::trim() > 0);
+
+    // trim之后内存池仍可正常使用
+    blocks.clear();
+    for (int i = 0; i != 10000; ++i) {
+        void *p = alloc::allocate(64);
+        memset(p, 0x3c, 64);
+        blocks.push_back(p);
+    }
+    for (void *p : blocks) {
+        alloc::deallocate(p, 64);
+    }
+    alloc::set_trim_threshold(32 * 256 * 1024);
+}
+
+// 开启大页arena后分配正常，arena中的chunk不会被trim释放
+void testCase6(){
+    alloc::set_trim_threshold(0);
+    alloc::set_huge_page_arena(true);
+    std::vector<void*> blocks;
+    for (int i = 0; i != 100000; ++i) {
+        void *p = alloc::allocate(96);
+        memset(p, 0x5a, 96);
+        blocks.push_back(p);
+    }
+    for (void *p : blocks) {
+        alloc::deallocate(p, 96);
+    }
+    alloc::trim();
+    // arena中的区块在trim之后仍留在内存池，可以再次分配使用
+    void *p = alloc::allocate(96);
+    memset(p, 0x5a, 96);
+    alloc::deallocate(p, 96);
+    alloc::set_huge_page_arena(false);
+    alloc::set_trim_threshold(32 * 256 * 1024);
+}
+
+// 统计信息反映本线程和已退出线程的分配
+void testCase7(){
+    alloc::stats before, after;
+    alloc::get_stats(before);
+    std::vector<void*> blocks;
+    for (int i = 0; i != 1000; ++i) {
+        blocks.push_back(alloc::allocate(200)); // 200字节属于224字节级别
+    }
+    void *large = alloc::allocate(40000);
+    std::thread t([]{
+        for (int i = 0; i != 100; ++i) {
+            alloc::deallocate(alloc::allocate(24), 24);
+        }
+    });
+    t.join();
+    alloc::get_stats(after);
+
+    const alloc::class_stats *b = before.size_class, *a = after.size_class;
+    size_t index = 0;
+    while (a[index].block_size < 200) ++index;
+    assert(a[index].block_size == 224);
+    assert(a[index].allocs - b[index].allocs == 1000);
+    assert(a[index].live - b[index].live == 1000);
+    assert(a[2].allocs - b[2].allocs == 100); // 24字节位于第2个free-list
+    assert(a[2].frees - b[2].frees == 100);
+    assert(after.requested_bytes - before.requested_bytes == 200 * 1000);
+    assert(after.live_bytes - before.live_bytes == 224 * 1000);
+    assert(after.large_allocs - before.large_allocs == 1);
+    assert(after.large_bytes - before.large_bytes == 40000);
+    assert(after.heap_size >= after.live_bytes + after.free_bytes);
+
+    for (void *p : blocks) {
+        alloc::deallocate(p, 200);
+    }
+    alloc::deallocate(large, 40000);
+    alloc::get_stats(after);
+    assert(after.size_class[index].live == before.size_class[index].live);
+    assert(after.large_bytes == before.large_bytes);
+}
+
+// 采样间隔为1字节时每次分配都被采样，释放后采样记录随之删除
+void testCase8(){
+    alloc::set_sample_interval(1);
+    std::vector<void*> blocks;
+    for (int i = 0; i != 100; ++i) {
+        blocks.push_back(alloc::allocate(64));
+    }
+    blocks.push_back(alloc::allocate(40000));
+    alloc::set_sample_interval(0);
+
+    std::ostringstream profile;
+    alloc::write_heap_profile(profile);
+    assert(profile.str().find("heap profile: 101: 46400 [0: 0] @ heap_v2/0") == 0);
+    assert(profile.str().find("MAPPED_LIBRARIES:") != std::string::npos);
+    std::ostringstream text;
+    alloc::print_heap_profile(text);
+    assert(text.str().find("heap profile: 101 samples") == 0);
+    assert(text.str().find("allocated at:") != std::string::npos);
+
+    for (void *p : blocks) {
+        alloc::deallocate(p, p == blocks.back() ? 40000 : 64);
+    }
+    profile.str("");
+    alloc::write_heap_profile(profile);
+    assert(profile.str().find("heap profile: 0: 0") == 0);
+}
+
+//allocate_chain/deallocate_chain与list的成批配置
+void testCase9(){
+    alloc::stats before, after;
+    alloc::get_stats(before);
+    void *chain = alloc::allocate_chain(40, 1000); // 40字节位于第4个free-list
+    size_t count = 0;
+    for (void *p = chain; p; p = *static_cast<void **>(p)) {
+        std::memset(static_cast<char *>(p) + sizeof(void *), 0xab, 40 - sizeof(void *));
+        ++count;
+    }
+    assert(count == 1000);
+    alloc::get_stats(after);
+    assert(after.size_class[4].allocs - before.size_class[4].allocs == 1000);
+    assert(after.requested_bytes - before.requested_bytes == 40 * 1000);
+    alloc::deallocate_chain(chain, 40, 1000);
+    alloc::get_stats(after);
+    assert(after.size_class[4].live == before.size_class[4].live);
+    assert(after.requested_bytes == before.requested_bytes);
+
+    void *large = alloc::allocate_chain(40000, 3);
+    alloc::deallocate_chain(large, 40000, 3);
+    alloc::get_stats(after);
+    assert(after.large_allocs - before.large_allocs == 3);
+    assert(after.large_bytes == before.large_bytes);
+
+    alloc::get_stats(before);
+    {
+        list<int> l(1000, 7); // list<int>的节点为24字节，位于第2个free-list
+        int values[] = { 1, 2, 3, 4, 5 };
+        l.insert(l.begin(), values, values + 5);
+        alloc::get_stats(after);
+        assert(after.size_class[2].live - before.size_class[2].live == 1006);
+        assert(*l.begin() == 1 && l.back() == 7);
+        l.clear();
+        alloc::get_stats(after);
+        assert(after.size_class[2].live - before.size_class[2].live == 1);
+    }
+    alloc::get_stats(after);
+    assert(after.size_class[2].live == before.size_class[2].live);
+}
+
+//按缓存行对齐的类型
+struct alignas(64) padded_counter {
+    long value;
+    padded_counter(long v = 0) : value(v) {}
+};
+
+static bool is_aligned(const void *p, size_t align) {
+    return reinterpret_cast<size_t>(p) % align == 0;
+}
+
+//配置总是失败的策略，只提供allocate/deallocate
+struct failing_alloc {
+    static void *allocate(size_t) { return 0; }
+    static void deallocate(void *, size_t) {}
+};
+
+//对齐分配：alloc::allocate_aligned、align_alloc与超过8字节对齐的元素类型
+void testCase10(){
+    size_t sizes[] = { 1, 100, 1000, 40000 };
+    size_t aligns[] = { 8, 16, 64, 4096 };
+    for (size_t n : sizes) {
+        for (size_t align : aligns) {
+            void *p = alloc::allocate_aligned(n, align);
+            assert(is_aligned(p, align));
+            std::memset(p, 0xcd, n);
+            alloc::deallocate_aligned(p, n, align);
+        }
+    }
+    failing_alloc failing;
+    assert(aligned_allocate(failing, 100, 64) == 0); //配置失败时返回0，不写入对齐地址之前的字
+
+    vector<float, align_alloc<64> > floats(1000, 1.0f);
+    assert(is_aligned(&*floats.begin(), 64));
+    floats.push_back(2.0f); //重新配置后的缓冲区同样对齐
+    assert(is_aligned(&*floats.begin(), 64) && floats.back() == 2.0f);
+
+    vector<padded_counter> counters(10, padded_counter(3));
+    assert(is_aligned(&*counters.begin(), 64) && counters[9].value == 3);
+
+    deque<padded_counter> dq;
+    for (long i = 0; i != 100; ++i) dq.push_back(padded_counter(i));
+    for (long i = 0; i != 100; ++i) assert(is_aligned(&dq[i], 64) && dq[i].value == i);
+
+    list<padded_counter> lst(50, padded_counter(7));
+    for (list<padded_counter>::iterator it = lst.begin(); it != lst.end(); ++it)
+        assert(is_aligned(&*it, 64) && it->value == 7);
+    lst.clear();
+}
+
+//生产者/消费者：其他线程释放的区块进入所属线程的远程释放队列，由所属线程取回
+void testCase11(){
+    const size_t index = 6; // 56字节位于第6个free-list
+    std::vector<void*> blocks;
+    for (int i = 0; i != 1000; ++i) {
+        blocks.push_back(alloc::allocate(56));
+    }
+    alloc::stats before, after;
+    alloc::get_stats(before);
+    std::thread consumer([&blocks]{
+        for (void *p : blocks) {
+            alloc::deallocate(p, 56);
+        }
+    });
+    consumer.join();
+    alloc::get_stats(after);
+    assert(after.size_class[index].live - before.size_class[index].live == static_cast<size_t>(-1000));
+    assert(after.size_class[index].remote_free > before.size_class[index].remote_free);
+
+    // 缓存用尽后取回远程释放队列中的区块
+    blocks.clear();
+    for (int i = 0; i != 1000; ++i) {
+        blocks.push_back(alloc::allocate(56));
+    }
+    alloc::get_stats(after);
+    assert(after.size_class[index].remote_free == 0);
+    for (void *p : blocks) {
+        alloc::deallocate(p, 56);
+    }
+
+    // 多个生产者与消费者交叉释放
+    std::vector<std::thread> threads;
+    std::mutex mutex;
+    std::vector<void*> shared;
+    for (int t = 0; t != 4; ++t) {
+        threads.push_back(std::thread([&mutex, &shared, t]{
+            for (int round = 0; round != 100; ++round) {
+                std::vector<void*> mine;
+                for (int i = 0; i != 50; ++i) {
+                    void *p = alloc::allocate(56);
+                    memset(p, t, 56);
+                    mine.push_back(p);
+                }
+                std::lock_guard<std::mutex> lock(mutex);
+                for (void *p : shared) {
+                    alloc::deallocate(p, 56);
+                }
+                shared.swap(mine);
+            }
+        }));
+    }
+    for (std::thread& t : threads) t.join();
+    for (void *p : shared) {
+        alloc::deallocate(p, 56);
+    }
+    alloc::get_stats(after);
+    assert(after.size_class[index].live == before.size_class[index].live - 1000);
+
+    // 整链释放（list::clear等经deallocate_chain释放）同样按所属线程进入远程释放队列
+    void *chain = alloc::allocate_chain(56, 500); // 可能先取回远程释放队列，之后再取统计
+    alloc::get_stats(before);
+    std::thread chain_consumer([chain]{
+        alloc::deallocate_chain(chain, 56, 500);
+    });
+    chain_consumer.join();
+    alloc::get_stats(after);
+    assert(after.size_class[index].remote_free > before.size_class[index].remote_free);
+}
+
+//复制构造函数不平凡，vector扩容时逐个复制而不经reallocate
+struct tracked_int {
+    int value;
+    tracked_int(int v) : value(v) {}
+    tracked_int(const tracked_int& x) : value(x.value) {}
+};
+
+//allocate_at_least返回区块的实际容量，容器以此作为capacity
+void testCase12(){
+    size_t count = 0;
+    void *p = alloc::allocate_at_least(100, 1, count);
+    assert(count == 104); //100字节落在104字节的级别
+    alloc::deallocate(p, count);
+    p = alloc::allocate_at_least(5, 12, count);
+    assert(count == 5); //60字节的级别为64字节，只能容纳5个
+    alloc::deallocate(p, count * 12);
+
+    alloc::stats before, after;
+    alloc::get_stats(before);
+    p = alloc::allocate_at_least(40000, 1, count);
+    assert(count >= 40000);
+    std::memset(p, 0xcd, count);
+    alloc::deallocate(p, count);
+    alloc::get_stats(after);
+    assert(after.large_bytes == before.large_bytes);
+
+    allocator<int, alloc> a;
+    int *q = a.allocate_at_least(3, count);
+    assert(count == 4);
+    a.deallocate(q, count);
+
+    vector<tracked_int> v;
+    v.push_back(0);
+    assert(v.capacity() == 2); //第一次只请求1个元素，8字节的区块可容纳2个
+    size_t reallocs = 0;
+    for (int i = 1; i != 1000; ++i) {
+        if (v.size() == v.capacity()) ++reallocs;
+        v.push_back(i);
+    }
+    assert(reallocs <= 10);
+    v.reserve(5000);
+    assert(v.capacity() >= 5000 && v.size() == 1000);
+    for (int i = 0; i != 1000; ++i) assert(v[i].value == i);
+
+    string s;
+    s.reserve(10);
+    assert(s.capacity() == 16);
+    s.append("0123456789abcdef");
+    assert(s.capacity() == 16 && s.size() == 16);
+    s.append(100, 'x');
+    assert(s.capacity() >= 116 && s.size() == 116 && s[15] == 'f' && s[115] == 'x');
+
+    deque<int> dq;
+    for (int i = 0; i != 100000; ++i) dq.push_back(i);
+    for (int i = 0; i != 1000; ++i) dq.push_front(-i);
+    assert(dq.size() == 101000 && dq[1000] == 0 && dq[100999] == 99999);
+}
+
+//reallocate保留内容：同级别原地返回，大区块经realloc调整，统计保持平衡
+void testCase13(){
+    alloc::stats before, after;
+    alloc::get_stats(before);
+    char *p = static_cast<char *>(alloc::allocate(10));
+    std::memset(p, 1, 10);
+    char *q = static_cast<char *>(alloc::reallocate(p, 10, 16));
+    assert(q == p); //10字节与16字节同属一级
+    std::memset(q + 10, 2, 6);
+    size_t sizes[] = { 100, 5000, 40000, 1 << 20, 64 << 20, 50000, 200, 16 };
+    size_t old_sz = 16;
+    for (size_t new_sz : sizes) {
+        q = static_cast<char *>(alloc::reallocate(q, old_sz, new_sz));
+        assert(q[0] == 1 && q[9] == 1 && q[10] == 2 && q[15] == 2);
+        old_sz = new_sz;
+    }
+    alloc::deallocate(q, old_sz);
+    alloc::get_stats(after);
+    assert(after.large_bytes == before.large_bytes);
+    assert(after.requested_bytes == before.requested_bytes);
+
+    q = static_cast<char *>(alloc::reallocate(0, 0, 100)); //空指针等同于allocate
+    alloc::deallocate(q, 100);
+}
+
+void testAllCases(){
+    testCase1();
+    testCase2();
+    testCase3();
+    testCase4();
+    testCase5();
+    testCase6();
+    testCase7();
+    testCase8();
+    testCase9();
+    testCase10();
+    testCase11();
+    testCase12();
+    testCase13();
+}
+
+} // namespace alloctest
+} // namespace mystl
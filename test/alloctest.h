@@ -0,0 +1,39 @@
+#ifndef MYSTL_ALLOC_TEST_H_
+#define MYSTL_ALLOC_TEST_H_
+
+#include "../alloc.h"
+#include "../deque.h"
+#include "../list.h"
+#include "../string.h"
+#include "../vector.h"
+
+#include <cassert>
+#include <cstring>
+#include <mutex>
+#include <sstream>
+#include <thread>
+#include <vector>
+
+namespace mystl{
+namespace alloctest{
+
+void testCase1();
+void testCase2();
+void testCase3();
+void testCase4();
+void testCase5();
+void testCase6();
+void testCase7();
+void testCase8();
+void testCase9();
+void testCase10();
+void testCase11();
+void testCase12();
+void testCase13();
+
+void testAllCases();
+
+} // namespace alloctest
+} // namespace mystl
+
+#endif
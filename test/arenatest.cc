@@ -0,0 +1,89 @@
+#include "arenatest.h"
+
+namespace mystl{
+namespace arenatest{
+
+// 区块顺序切分且按8字节对齐，超过内存块大小的请求也能满足
+void testCase1(){
+    monotonic_arena arena;
+    char *p1 = static_cast<char*>(arena.allocate(5));
+    char *p2 = static_cast<char*>(arena.allocate(16));
+    assert(p2 == p1 + 8);
+    assert(arena.bytes_allocated() == 24);
+
+    char *big = static_cast<char*>(arena.allocate(3 * 1024 * 1024));
+    memset(big, 0x7f, 3 * 1024 * 1024);
+    char *p3 = static_cast<char*>(arena.allocate(8));
+    memset(p3, 0, 8);
+    assert(reinterpret_cast<size_t>(p3) % 8 == 0);
+}
+
+// release之后复用最近的内存块
+void testCase2(){
+    monotonic_arena arena;
+    for (int i = 0; i != 10000; ++i) {
+        memset(arena.allocate(40), 0x11, 40);
+    }
+    arena.release();
+    assert(arena.bytes_allocated() == 0);
+    void *p1 = arena.allocate(40);
+    arena.release();
+    void *p2 = arena.allocate(40);
+    assert(p1 == p2);
+}
+
+// 作为容器的Alloc策略
+struct request_tag {};
+void testCase3(){
+    typedef monotonic_alloc<request_tag> request_alloc;
+    {
+        mystl::list<int, request_alloc> lst;
+        mystl::map<int, int, std::less<int>, request_alloc> m;
+        for (int i = 0; i != 1000; ++i) {
+            lst.push_back(i);
+            m.insert(mystl::make_pair(i, i * i));
+        }
+        int expect = 0;
+        for (auto it = lst.begin(); it != lst.end(); ++it, ++expect)
+            assert(*it == expect);
+        assert(m.size() == 1000);
+        assert(m.find(30)->second == 900);
+        assert(request_alloc::arena().bytes_allocated() > 0);
+    }
+    request_alloc::release();
+    assert(request_alloc::arena().bytes_allocated() == 0);
+    assert(monotonic_alloc<>::arena().bytes_allocated() == 0);
+}
+
+//按2的幂对齐切分
+void testCase4(){
+    monotonic_arena arena;
+    size_t aligns[] = { 16, 64, 4096 };
+    for (int round = 0; round != 100; ++round) {
+        arena.allocate(round % 13 + 1); //打乱当前位置的对齐
+        for (size_t align : aligns) {
+            char *p = static_cast<char *>(arena.allocate(round * 97 + 1, align));
+            assert(reinterpret_cast<size_t>(p) % align == 0);
+            memset(p, round, round * 97 + 1);
+        }
+    }
+    //monotonic_alloc按类型的对齐切分节点
+    struct alignas(64) line { int value; };
+    mystl::list<line, monotonic_alloc<> > lst;
+    for (int i = 0; i != 100; ++i) {
+        line l = { i };
+        lst.push_back(l);
+    }
+    for (auto it = lst.begin(); it != lst.end(); ++it)
+        assert(reinterpret_cast<size_t>(&*it) % 64 == 0);
+}
+
+void testAllCases(){
+    testCase1();
+    testCase2();
+    testCase3();
+    testCase4();
+}
+
+} // namespace arenatest
+} // namespace mystl
@@ -0,0 +1,24 @@
+#ifndef MYSTL_ARENA_TEST_H_
+#define MYSTL_ARENA_TEST_H_
+
+#include "../arena.h"
+#include "../list.h"
+#include "../map.h"
+
+#include <cassert>
+#include <cstring>
+
+namespace mystl{
+namespace arenatest{
+
+void testCase1();
+void testCase2();
+void testCase3();
+void testCase4();
+
+void testAllCases();
+
+} // namespace arenatest
+} // namespace mystl
+
+#endif
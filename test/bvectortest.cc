@@ -0,0 +1,199 @@
+#include "bvectortest.h"
+
+namespace mystl{
+namespace bvectortest{
+
+typedef mystl::vector<bool> bitVec;
+typedef std::vector<bool> stdBitVec;
+
+// 逐位比较，同时检查末尾的字中多余的位为0（count与rank依赖于此）
+static bool equal(const bitVec& v1, const stdBitVec& v2){
+    if (!mystl::test::container_equal(v1, v2)) return false;
+    size_t ones = 0;
+    for (size_t i = 0; i != v2.size(); ++i) ones += v2[i];
+    return v1.count() == ones;
+}
+
+// 构造、代理引用与迭代器
+void testCase1(){
+    bitVec v1(100, true);
+    assert(v1.size() == 100 && v1.count() == 100 && v1.capacity() >= 100);
+    assert(v1.capacity() < 100 * 8); // 每个元素只占1位
+
+    bitVec v2{ true, false, true, true };
+    stdBitVec s2{ true, false, true, true };
+    assert(equal(v2, s2));
+    v2[1] = v2[0];
+    v2[0].flip();
+    s2[1] = s2[0];
+    s2[0].flip();
+    assert(equal(v2, s2));
+    swap(v2[2], v2[0]);
+    assert(!v2[2] && v2[0]);
+
+    bitVec v3(v2.begin() + 1, v2.end());
+    assert(v3.size() == 3 && v3[0] && !v3[1] && v3[2]);
+    assert(v2.end() - v2.begin() == 4 && *(v2.begin() + 3) == v2.back());
+    bitVec::const_iterator it = v1.cbegin();
+    it += 70;
+    assert(*it && it - v1.cbegin() == 70 && (it - 70) == v1.cbegin());
+
+    bitVec v4(v1), v5(std::move(v1));
+    assert(v4 == v5 && v1.empty());
+    v4[99] = false;
+    assert(v4 != v5);
+    v1 = v4;
+    assert(v1 == v4);
+    bitVec v6(5, 1); // 整数参数等同于(n, value)
+    assert(v6.size() == 5 && v6.count() == 5);
+}
+
+// push_back、pop_back、insert、erase、resize与std::vector<bool>对比
+void testCase2(){
+    bitVec v;
+    stdBitVec s;
+    std::srand(17);
+    for (int i = 0; i != 3000; ++i){
+        bool x = std::rand() % 3 == 0;
+        size_t pos = s.empty() ? 0 : std::rand() % s.size();
+        switch (std::rand() % 6){
+        case 0: case 1:
+            v.push_back(x); s.push_back(x); break;
+        case 2:
+            v.insert(v.begin() + pos, x); s.insert(s.begin() + pos, x); break;
+        case 3:
+            v.insert(v.begin() + pos, 70, x); s.insert(s.begin() + pos, 70, x); break;
+        case 4:
+            if (!s.empty()){
+                size_t n = std::rand() % (s.size() - pos + 1);
+                v.erase(v.begin() + pos, v.begin() + pos + n);
+                s.erase(s.begin() + pos, s.begin() + pos + n);
+            }
+            break;
+        case 5:
+            if (!s.empty()){ v.pop_back(); s.pop_back(); }
+            break;
+        }
+    }
+    assert(equal(v, s));
+
+    v.resize(v.size() / 2); s.resize(s.size() / 2);
+    assert(equal(v, s));
+    v.resize(v.size() + 200, true); s.resize(s.size() + 200, true);
+    assert(equal(v, s));
+    v.shrink_to_fit();
+    assert(equal(v, s) && v.capacity() - v.size() < 64);
+
+    const bool arr[] = { true, true, false };
+    v.insert(v.begin() + 5, arr, arr + 3);
+    s.insert(s.begin() + 5, arr, arr + 3);
+    assert(equal(v, s));
+    v.clear();
+    assert(v.empty() && v.count() == 0);
+    v.assign(130, true);
+    assert(v.size() == 130 && v.count() == 130);
+}
+
+// count、find、rank逐字完成
+void testCase3(){
+    bitVec v(1000, false);
+    assert(v.none() && v.find(true) == bitVec::npos && v.find(false) == 0);
+    v[3] = v[64] = v[200] = v[999] = true;
+    assert(v.count() == 4 && v.any() && !v.all());
+    assert(v.find(true) == 3 && v.find(true, 4) == 64 && v.find(true, 65) == 200);
+    assert(v.find(true, 200) == 200 && v.find(true, 201) == 999);
+    assert(v.find(true, 1000) == bitVec::npos);
+    assert(v.rank(0) == 0 && v.rank(3) == 0 && v.rank(4) == 1);
+    assert(v.rank(64) == 1 && v.rank(65) == 2 && v.rank(1000) == 4);
+
+    bitVec w(130, true);
+    assert(w.all() && w.find(false) == bitVec::npos); // 末尾多余的位不会被当作0找到
+    w[129] = false;
+    assert(w.find(false) == 129 && w.find(false, 129) == 129);
+    assert(!bitVec().any() && bitVec().all() && bitVec().count() == 0);
+}
+
+// flip与按位运算
+void testCase4(){
+    bitVec a, b;
+    stdBitVec sa, sb;
+    std::srand(5);
+    for (int i = 0; i != 777; ++i){
+        bool x = std::rand() % 2 == 0, y = std::rand() % 5 == 0;
+        a.push_back(x); sa.push_back(x);
+        b.push_back(y); sb.push_back(y);
+    }
+    a.flip();
+    sa.flip();
+    assert(equal(a, sa));
+    for (size_t pos = 0; pos != sa.size(); pos += 37){ // find与逐位扫描的结果一致
+        size_t expect = pos;
+        while (expect != sa.size() && sa[expect]) ++expect;
+        assert(a.find(false, pos) == (expect == sa.size() ? bitVec::npos : expect));
+    }
+
+    bitVec c(a);
+    c &= b;
+    for (size_t i = 0; i != sa.size(); ++i) assert(c[i] == (sa[i] && sb[i]));
+    c = a;
+    c |= b;
+    for (size_t i = 0; i != sa.size(); ++i) assert(c[i] == (sa[i] || sb[i]));
+    c = a;
+    c ^= b;
+    for (size_t i = 0; i != sa.size(); ++i) assert(c[i] == (sa[i] != sb[i]));
+    c ^= c;
+    assert(c.none() && c.size() == 777);
+}
+
+// 只能单遍读取的输入迭代器
+struct input_iter {
+    typedef input_iterator_tag  iterator_category;
+    typedef bool                value_type;
+    typedef ptrdiff_t           difference_type;
+    typedef const bool*         pointer;
+    typedef bool                reference;
+    const bool *p;
+    bool operator*() const { return *p; }
+    input_iter& operator++() { ++p; return *this; }
+    bool operator!=(const input_iter& x) const { return p != x.p; }
+};
+
+// 跨字边界的任意位置与长度插入、删除，输入迭代器区间插入
+void testCase5(){
+    bitVec v;
+    stdBitVec s;
+    std::srand(29);
+    for (int i = 0; i != 500; ++i){ bool x = std::rand() % 2 == 0; v.push_back(x); s.push_back(x); }
+    bool arr[300];
+    for (int i = 0; i != 2000; ++i){
+        size_t pos = std::rand() % (s.size() + 1);
+        size_t n = std::rand() % 200;
+        if (std::rand() % 2 == 0){
+            for (size_t k = 0; k != n; ++k) arr[k] = std::rand() % 2 == 0;
+            if (std::rand() % 2 == 0){
+                v.insert(v.begin() + pos, arr, arr + n);
+            } else {
+                input_iter first = { arr }, last = { arr + n };
+                v.insert(v.begin() + pos, first, last);
+            }
+            s.insert(s.begin() + pos, arr, arr + n);
+        } else {
+            n = std::min(n, s.size() - pos);
+            v.erase(v.begin() + pos, v.begin() + pos + n);
+            s.erase(s.begin() + pos, s.begin() + pos + n);
+        }
+        if (s.size() > 5000){ v.resize(500); s.resize(500); }
+    }
+    assert(equal(v, s));
+}
+
+void testAllCases(){
+    testCase1();
+    testCase2();
+    testCase3();
+    testCase4();
+    testCase5();
+}
+
+} // namespace bvectortest
+} // namespace mystl
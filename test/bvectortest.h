@@ -0,0 +1,27 @@
+#ifndef MYSTL_BVECTOR_TEST_H_
+#define MYSTL_BVECTOR_TEST_H_
+
+#include "../vector.h"
+#include "testutil.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstdlib>
+#include <vector>
+
+namespace mystl{
+namespace bvectortest{
+
+void testCase1();
+void testCase2();
+void testCase3();
+void testCase4();
+void testCase5();
+
+void testAllCases();
+
+} // namespace bvectortest
+} // namespace mystl
+
+#endif
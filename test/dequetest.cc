@@ -1,6 +1,20 @@
 #include "dequetest.h"
 
+#include "../algorithm.h" // 与heap.h有重复的定义，只在本文件中包含
+
 namespace mystl{
+namespace dequetest{
+struct pageRecord { // 缓冲区按4096字节计，见testCase8
+    int value;
+    char pad[60];
+};
+} // namespace dequetest
+
+template<>
+struct deque_buffer_bytes<dequetest::pageRecord> {
+    static constexpr size_t value = 4096;
+};
+
 namespace dequetest{
 void testCase1(){
     stdDq<int> dq1(10, 0);
@@ -92,6 +106,192 @@ void testCase6(){
 }
 */
 
+// 计数配置与释放次数的配置策略
+struct counting_alloc {
+    static int allocs;
+    static int deallocs;
+    static void *allocate(size_t n) {
+        ++allocs;
+        return alloc::allocate(n);
+    }
+    static void deallocate(void *p, size_t n) {
+        ++deallocs;
+        alloc::deallocate(p, n);
+    }
+};
+int counting_alloc::allocs = 0;
+int counting_alloc::deallocs = 0;
+
+// 首尾在缓冲区边界附近来回时复用缓存的缓冲区，不再配置内存
+void testCase7(){
+    {
+        mystl::deque<int, counting_alloc> dq;
+        stdDq<int> sdq;
+        for (int i = 0; i != 100; ++i){ dq.push_back(i); sdq.push_back(i); }
+        for (int i = 0; i != 1000; ++i){ // 首次跨过缓冲区边界时才配置第二个缓冲区
+            dq.push_back(i); sdq.push_back(i);
+            dq.pop_front(); sdq.pop_front();
+        }
+        int before = counting_alloc::allocs;
+        for (int i = 100; i != 100000; ++i){
+            dq.push_back(i); sdq.push_back(i);
+            dq.pop_front(); sdq.pop_front();
+        }
+        assert(counting_alloc::allocs == before);
+        assert(mystl::test::container_equal(dq, sdq));
+
+        before = counting_alloc::allocs;
+        for (int i = 0; i != 10000; ++i){
+            dq.push_front(i); dq.pop_back();
+            dq.push_back(i); dq.pop_front();
+        }
+        assert(counting_alloc::allocs == before && dq.size() == 100);
+        dq.clear();
+        for (int i = 0; i != 1000; ++i) dq.push_back(i);
+    }
+    assert(counting_alloc::allocs == counting_alloc::deallocs);
+}
+
+// 缓冲区大小为2的幂，随机访问与迭代器前后跳转的结果与std::deque相同
+struct record12 {
+    int a, b, c;
+};
+
+template<typename Deque>
+static void check_random_access(Deque& dq, stdDq<int>& sdq){
+    for (size_t i = 0; i < sdq.size(); i += 7) assert(dq[i].value == sdq[i]);
+    auto it = dq.begin() + 5;
+    for (int step : { 1, 3, 31, 32, 33, 100, 129, 1000 }){
+        for (size_t i = 0; i + step < sdq.size(); i += step){
+            auto a = dq.begin() + i, b = a + step;
+            assert(b->value == sdq[i + step] && (b - step)->value == sdq[i]);
+            assert(b - a == step && a - b == -step);
+            it = b;
+            it -= step;
+            assert(it == a);
+        }
+    }
+}
+
+struct intRecord {
+    int value;
+    char pad[8];
+    intRecord(int v = 0) : value(v) {}
+};
+
+void testCase8(){
+    static_assert(myDq<int>::iterator::buffer_size() == 128, "512 bytes of int");
+    static_assert(myDq<record12>::iterator::buffer_size() == 32, "rounded down to a power of two");
+    static_assert(mystl::deque<int, alloc, 10>::iterator::buffer_size() == 16, "rounded up");
+    static_assert(myDq<pageRecord>::iterator::buffer_size() == 64, "specialized to 4096 bytes");
+
+    stdDq<int> sdq;
+    myDq<intRecord> dq1;
+    mystl::deque<intRecord, alloc, 3> dq2;
+    for (int i = 0; i != 3000; ++i){
+        if (i % 3 == 0){
+            sdq.push_front(i); dq1.push_front(i); dq2.push_front(i);
+        } else {
+            sdq.push_back(i); dq1.push_back(i); dq2.push_back(i);
+        }
+    }
+    for (int i = 0; i != 500; ++i){
+        sdq.pop_front(); dq1.pop_front(); dq2.pop_front();
+    }
+    check_random_access(dq1, sdq);
+    check_random_access(dq2, sdq);
+
+    myDq<pageRecord> dq3;
+    for (int i = 0; i != 1000; ++i) dq3.push_back(pageRecord{ i, {} });
+    assert(dq3[999].value == 999 && (dq3.end() - 1)->value == 999);
+}
+
+// 分段处理的算法与逐个元素处理的结果相同
+struct sumFn {
+    long long sum;
+    sumFn() : sum(0) {}
+    void operator()(int x) { sum += x; }
+};
+
+void testCase9(){
+    myDq<int> dq;
+    stdDq<int> sdq;
+    for (int i = 0; i != 1000; ++i){
+        if (i % 4 == 0){
+            dq.push_front(i); sdq.push_front(i);
+        } else {
+            dq.push_back(i); sdq.push_back(i);
+        }
+    }
+    std::vector<int> v(sdq.begin(), sdq.end());
+
+    // for_each与find，区间分别在一段之内、跨两段与跨多段
+    for (size_t from : { 0, 3, 127, 130, 500 }){
+        for (size_t to : { from, from + 1, from + 90, from + 300, size_t(1000) }){
+            if (to > 1000) continue;
+            const myDq<int>& cdq = dq;
+            long long sum = 0;
+            for (size_t i = from; i != to; ++i) sum += v[i];
+            assert(mystl::for_each(cdq.begin() + from, cdq.begin() + to, sumFn()).sum == sum);
+            for (size_t i = from; i < to; i += 37)
+                assert(mystl::find(cdq.begin() + from, cdq.begin() + to, v[i]) - cdq.begin() == std::find(v.begin() + from, v.begin() + to, v[i]) - v.begin());
+            assert(mystl::find(dq.begin() + from, dq.begin() + to, -1) == dq.begin() + to);
+        }
+    }
+
+    // equal，第一个与第二个区间分别是deque或原生指针
+    myDq<int> dq2;
+    for (int i = 0; i != 1000; ++i) dq2.push_back(v[i]);
+    assert(mystl::equal(dq.begin(), dq.end(), v.data()));
+    assert(mystl::equal(v.data(), v.data() + v.size(), dq.begin()));
+    assert(mystl::equal(dq.begin(), dq.end(), dq2.begin()));
+    assert(mystl::equal(dq.begin() + 100, dq.end(), dq2.begin() + 100));
+    dq2[777] = -1;
+    assert(!mystl::equal(dq.begin(), dq.end(), dq2.begin()));
+    assert(!mystl::equal(dq2.begin(), dq2.end(), v.data()));
+    assert(mystl::equal(dq2.begin(), dq2.begin() + 777, v.data()));
+
+    // copy：deque到数组、数组到deque、deque到deque（两者的段错开）
+    std::vector<int> out(1000);
+    assert(mystl::copy(dq.begin() + 5, dq.end(), out.data()) == out.data() + 995);
+    assert(std::equal(v.begin() + 5, v.end(), out.begin()));
+    for (int i = 0; i != 1000; ++i) out[i] = -i;
+    assert(mystl::copy(out.data() + 10, out.data() + 700, dq2.begin() + 1) == dq2.begin() + 691);
+    for (int i = 0; i != 1000; ++i)
+        assert(dq2[i] == (i >= 1 && i < 691 ? -(i + 9) : (i == 777 ? -1 : v[i])));
+    const myDq<int>& cdq = dq;
+    assert(mystl::copy(cdq.begin() + 3, cdq.begin() + 903, dq2.begin() + 50) == dq2.begin() + 950);
+    for (int i = 50; i != 950; ++i) assert(dq2[i] == v[i - 47]);
+
+    // 同一deque内向前移动，源区间与目的区间重叠
+    for (size_t shift : { 1, 5, 128, 200 }){
+        myDq<int> sh(dq2);
+        stdDq<int> ssh;
+        for (int i = 0; i != 1000; ++i) ssh.push_back(dq2[i]);
+        assert(mystl::copy(sh.begin() + shift, sh.end(), sh.begin()) == sh.end() - shift);
+        std::copy(ssh.begin() + shift, ssh.end(), ssh.begin());
+        for (int i = 0; i != 1000; ++i) assert(sh[i] == ssh[i]);
+    }
+    myDq<char> csh;
+    for (int i = 0; i != 3000; ++i) csh.push_back(char('a' + i % 26));
+    mystl::copy(csh.begin() + 1, csh.end(), csh.begin());
+    for (int i = 0; i != 2999; ++i) assert(csh[i] == char('a' + (i + 1) % 26));
+
+    // fill
+    mystl::fill(dq.begin() + 2, dq.end() - 2, 7);
+    for (int i = 0; i != 1000; ++i) assert(dq[i] == (i >= 2 && i < 998 ? 7 : v[i]));
+    myDq<char> cq(2000, 'a');
+    mystl::fill(cq.begin() + 1, cq.end() - 1, 'b');
+    assert(cq.front() == 'a' && cq.back() == 'a' && mystl::find(cq.begin() + 1, cq.end(), 'a') == cq.end() - 1);
+
+    // 非POD类型逐个赋值
+    myDq<std::string> sq(600, "x");
+    std::vector<std::string> sv(600);
+    for (int i = 0; i != 600; ++i) sv[i] = std::to_string(i);
+    mystl::copy(sv.data(), sv.data() + 600, sq.begin());
+    assert(mystl::equal(sq.begin(), sq.end(), sv.data()) && sq[599] == "599");
+}
+
 void testAllCases(){
     testCase1();
     //testCase2();
@@ -99,6 +299,9 @@ void testAllCases(){
     //testCase4();
     //testCase5();
     //testCase6();
+    testCase7();
+    testCase8();
+    testCase9();
 }
 
 } // namespace dequetest
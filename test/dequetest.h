@@ -8,6 +8,7 @@
 
 #include <cassert>
 #include <string>
+#include <vector>
 
 namespace mystl{
 namespace dequetest{
@@ -23,6 +24,9 @@ namespace dequetest{
 	void testCase4();
 	void testCase5();
 	void testCase6();
+	void testCase7();
+	void testCase8();
+	void testCase9();
 
 	void testAllCases();
 	
@@ -0,0 +1,110 @@
+#include "mapped_vectortest.h"
+
+namespace mystl{
+namespace mapped_vectortest{
+
+struct record {
+    int id;
+    double value;
+    char tag[4];
+};
+
+// 每个测试使用各自的临时文件，结束时删除
+static std::string temp_path(const char *name){
+    return std::string("/tmp/mystl_") + name + "_" + std::to_string(getpid());
+}
+
+// 写入后关闭，重新打开时元素原样可见
+void testCase1(){
+    std::string path = temp_path("mapped1");
+    {
+        mapped_vector<record> v(path.c_str());
+        assert(v.is_open() && v.empty() && v.capacity() > 0);
+        for (int i = 0; i != 100000; ++i){
+            record r = { i, i * 0.5, "ab" };
+            v.push_back(r);
+        }
+        assert(v.size() == 100000 && v.capacity() >= 100000);
+        assert(v[99999].id == 99999 && v.back().value == 99999 * 0.5);
+        v.sync();
+    }
+    {
+        mapped_view<record> v(path.c_str());
+        assert(v.is_open() && v.size() == 100000);
+        long long sum = 0;
+        for (auto it = v.begin(); it != v.end(); ++it) sum += it->id;
+        assert(sum == 99999LL * 100000 / 2 && v[12345].tag[1] == 'b');
+        static_assert(std::is_same<decltype(v[0]), const record&>::value,
+                      "mapped_view gives const access only");
+        static_assert(std::is_same<mapped_view<record>::iterator, const record*>::value,
+                      "mapped_view gives const access only");
+    }
+    std::remove(path.c_str());
+}
+
+// resize、pop_back、shrink_to_fit调整文件长度
+void testCase2(){
+    std::string path = temp_path("mapped2");
+    {
+        mapped_vector<int> v(path.c_str());
+        v.resize(10, 7);
+        v.resize(5000);
+        assert(v.size() == 5000 && v[9] == 7 && v[10] == 0 && v[4999] == 0);
+        v.push_back(v[9]); // value引用自身元素，扩展文件时不失效
+        assert(v.back() == 7);
+        v.pop_back();
+        v.resize(3);
+        v.shrink_to_fit();
+        assert(v.size() == 3 && v.capacity() == 3);
+        v.push_back(v[0]);
+        assert(v.size() == 4 && v[3] == 7);
+        v.reserve(5000);
+        assert(v.capacity() == 5000 && v.size() == 4);
+    }
+    {
+        mapped_vector<int> v(path.c_str());
+        assert(v.size() == 4 && v.capacity() == 5000 && v[3] == 7);
+        mapped_view<int> view(path.c_str()); // 共享映射，经mapped_vector的写入立即可见
+        v[3] = 9;
+        assert(view.size() == 4 && view[3] == 9);
+        v.clear();
+        assert(v.empty());
+    }
+    std::remove(path.c_str());
+}
+
+// 元素类型不匹配或文件不存在时抛出异常
+void testCase3(){
+    std::string path = temp_path("mapped3");
+    {
+        mapped_vector<double> v(path.c_str());
+        v.push_back(1.5);
+    }
+    bool thrown = false;
+    try { mapped_vector<record> v(path.c_str()); } catch (std::runtime_error&) { thrown = true; }
+    assert(thrown);
+    std::remove(path.c_str());
+
+    thrown = false;
+    try {
+        mapped_view<int> v(path.c_str());
+    } catch (std::runtime_error&) {
+        thrown = true;
+    }
+    assert(thrown);
+
+    mapped_vector<int> closed;
+    assert(!closed.is_open() && closed.size() == 0 && closed.empty());
+    assert(closed.begin() == closed.end() && closed.data() == 0);
+    mapped_view<int> closed_view;
+    assert(!closed_view.is_open() && closed_view.begin() == closed_view.end());
+}
+
+void testAllCases(){
+    testCase1();
+    testCase2();
+    testCase3();
+}
+
+} // namespace mapped_vectortest
+} // namespace mystl
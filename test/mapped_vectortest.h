@@ -0,0 +1,25 @@
+#ifndef MYSTL_MAPPED_VECTOR_TEST_H_
+#define MYSTL_MAPPED_VECTOR_TEST_H_
+
+#include "../mapped_vector.h"
+
+#include <cassert>
+#include <cstdio>
+#include <stdexcept>
+#include <string>
+
+#include <unistd.h>
+
+namespace mystl{
+namespace mapped_vectortest{
+
+void testCase1();
+void testCase2();
+void testCase3();
+
+void testAllCases();
+
+} // namespace mapped_vectortest
+} // namespace mystl
+
+#endif
@@ -0,0 +1,102 @@
+#include "memory_resourcetest.h"
+
+namespace mystl{
+namespace memory_resourcetest{
+
+// 计数每次分配与释放的memory_resource
+class counting_resource : public memory_resource {
+public:
+    size_t allocs = 0;
+    size_t deallocs = 0;
+protected:
+    virtual void *do_allocate(size_t bytes) {
+        ++allocs;
+        return pool_resource()->allocate(bytes);
+    }
+    virtual void do_deallocate(void *p, size_t bytes) {
+        ++deallocs;
+        pool_resource()->deallocate(p, bytes);
+    }
+};
+
+// 无状态的配置器不增加容器的大小
+void testCase1(){
+    static_assert(sizeof(mystl::vector<int>) == 3 * sizeof(void*), "vector");
+    static_assert(sizeof(mystl::list<int>) == sizeof(void*), "list");
+    static_assert(sizeof(mystl::vector<int, resource_alloc>) == 4 * sizeof(void*),
+                  "resource_alloc");
+}
+
+// 每个容器实例从各自的memory_resource分配，拷贝沿用源容器的resource
+void testCase2(){
+    counting_resource r1, r2;
+    {
+        mystl::list<int, resource_alloc> l1(&r1);
+        mystl::list<int, resource_alloc> l2(&r2);
+        for (int i = 0; i != 100; ++i) {
+            l1.push_back(i);
+        }
+        l2.push_back(1);
+        assert(r1.allocs == 101 && r2.allocs == 2); // 含头结点
+
+        mystl::list<int, resource_alloc> l3(l1);
+        assert(l3.get_allocator().resource() == &r1);
+        l3.swap(l2);
+        assert(l3.get_allocator().resource() == &r2);
+        assert(l2.get_allocator().resource() == &r1 && l2.back() == 99);
+
+        mystl::deque<int, resource_alloc> dq(&r2);
+        for (int i = 0; i != 1000; ++i) {
+            dq.push_back(i);
+        }
+        mystl::deque<int, resource_alloc> moved(std::move(dq));
+        assert(moved.size() == 1000 && dq.empty());
+
+        mystl::set<int, std::less<int>, resource_alloc> s(std::less<int>(), &r1);
+        for (int i = 0; i != 100; ++i) {
+            s.insert(i);
+        }
+        mystl::vector<int, resource_alloc> vec(&r2);
+        for (int i = 0; i != 100; ++i) {
+            vec.push_back(i);
+        }
+        assert(vec.get_allocator() == resource_alloc(&r2));
+    }
+    assert(r1.allocs == r1.deallocs);
+    assert(r2.allocs == r2.deallocs);
+}
+
+// 默认resource与monotonic_resource
+void testCase3(){
+    counting_resource r;
+    memory_resource *old = set_default_resource(&r);
+    assert(old == pool_resource());
+    {
+        mystl::list<int, resource_alloc> lst;
+        lst.push_back(1);
+    }
+    assert(r.allocs == 2 && r.deallocs == 2);
+    set_default_resource(0);
+    assert(get_default_resource() == pool_resource());
+
+    monotonic_resource arena;
+    {
+        mystl::set<int, std::less<int>, resource_alloc> s(std::less<int>(), &arena);
+        for (int i = 0; i != 1000; ++i) {
+            s.insert(i);
+        }
+        assert(arena.bytes_allocated() > 0);
+    }
+    arena.release();
+    assert(arena.bytes_allocated() == 0);
+    assert(*pool_resource() != arena);
+}
+
+void testAllCases(){
+    testCase1();
+    testCase2();
+    testCase3();
+}
+
+} // namespace memory_resourcetest
+} // namespace mystl
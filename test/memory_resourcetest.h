@@ -0,0 +1,24 @@
+#ifndef MYSTL_MEMORY_RESOURCE_TEST_H_
+#define MYSTL_MEMORY_RESOURCE_TEST_H_
+
+#include "../memory_resource.h"
+#include "../deque.h"
+#include "../list.h"
+#include "../set.h"
+#include "../vector.h"
+
+#include <cassert>
+
+namespace mystl{
+namespace memory_resourcetest{
+
+void testCase1();
+void testCase2();
+void testCase3();
+
+void testAllCases();
+
+} // namespace memory_resourcetest
+} // namespace mystl
+
+#endif
@@ -0,0 +1,151 @@
+#include "ring_buffertest.h"
+
+namespace mystl{
+namespace ring_buffertest{
+
+// 首尾进出反复跨过空间的末尾，结果与std::deque相同；扩容时元素保持顺序
+void testCase1(){
+    ring_buffer<int> rb;
+    std::deque<int> dq;
+    assert(rb.empty() && rb.capacity() == 0);
+    for (int i = 0; i != 100000; ++i){
+        rb.push_back(i);
+        dq.push_back(i);
+        if (i % 3 == 0){
+            assert(rb.front() == dq.front());
+            rb.pop_front();
+            dq.pop_front();
+        }
+        if (i % 1000 == 0){
+            while (rb.size() > 5){
+                rb.pop_front();
+                dq.pop_front();
+            }
+        }
+    }
+    assert(rb.size() == dq.size() && rb.front() == dq.front() && rb.back() == dq.back());
+    assert(mystl::test::container_equal(rb, dq));
+    assert((rb.capacity() & (rb.capacity() - 1)) == 0 && rb.capacity() >= rb.size());
+    for (size_t i = 0; i < dq.size(); i += 17) assert(rb[i] == dq[i] && rb.at(i) == dq[i]);
+    assert(rb.end() - rb.begin() == static_cast<ptrdiff_t>(rb.size()));
+    ring_buffer<int>::const_iterator it = rb.begin();
+    it += 10;
+    assert(*it == dq[10] && it[5] == dq[15] && rb.begin() < it);
+    rb.pop_back();
+    dq.pop_back();
+    assert(rb.back() == dq.back());
+
+    bool thrown = false;
+    try { rb.at(rb.size()); } catch (std::out_of_range&) { thrown = true; }
+    assert(thrown);
+}
+
+// fixed时不自动扩容，满时追加抛出异常且容器不变
+void testCase2(){
+    ring_buffer<int> rb(100, ring_buffer<int>::fixed);
+    assert(rb.capacity() == 128 && rb.mode() == ring_buffer<int>::fixed);
+    for (int round = 0; round != 3; ++round){
+        for (int i = 0; i != 128; ++i) rb.push_back(round * 1000 + i);
+        assert(rb.full());
+        bool thrown = false;
+        try { rb.push_back(-1); } catch (std::length_error&) { thrown = true; }
+        assert(thrown && rb.size() == 128 && rb.back() == round * 1000 + 127);
+        thrown = false;
+        int extra[2] = { -1, -1 };
+        try { rb.push_back_n(extra, 2); } catch (std::length_error&) { thrown = true; }
+        assert(thrown && rb.size() == 128);
+        for (int i = 0; i != 100; ++i){
+            assert(rb.front() == round * 1000 + i);
+            rb.pop_front();
+        }
+        rb.clear();
+    }
+    assert(rb.capacity() == 128);
+    rb.reserve(200); // 显式扩容
+    assert(rb.capacity() == 256 && rb.mode() == ring_buffer<int>::fixed);
+}
+
+// 批量追加与取出，经array_one/array_two直接访问两段连续区间
+void testCase3(){
+    ring_buffer<int> rb(64);
+    std::vector<int> src(1000), dst(1000);
+    for (int i = 0; i != 1000; ++i) src[i] = i;
+    std::deque<int> dq;
+    size_t in = 0, out = 0;
+    for (int round = 0; round != 50; ++round){
+        size_t n = (round * 7) % 50 + 1;
+        if (in + n > src.size()) break;
+        rb.push_back_n(src.data() + in, n);
+        in += n;
+        size_t m = std::min(rb.size(), n + round % 4);
+        assert(rb.pop_front_n(dst.data() + out, m) == dst.data() + out + m);
+        out += m;
+        std::pair<int *, size_t> one = rb.array_one(), two = rb.array_two();
+        assert(one.second + two.second == rb.size());
+        for (size_t i = 0; i != one.second; ++i) assert(one.first[i] == int(out + i));
+        for (size_t i = 0; i != two.second; ++i) assert(two.first[i] == int(out + one.second + i));
+    }
+    assert(rb.capacity() == 64); // 始终没有超出容量
+    for (size_t i = 0; i != out; ++i) assert(dst[i] == int(i));
+    rb.pop_front(rb.size());
+    assert(rb.empty());
+
+    // 跨过末尾的批量追加与扩容
+    ring_buffer<std::string> sb(4);
+    sb.push_back("a");
+    sb.push_back("b");
+    sb.push_back("c");
+    sb.pop_front();
+    sb.pop_front();
+    std::string strs[5] = { "d", "e", "f", "g", "h" };
+    sb.push_back_n(strs, 2); // c d | e
+    assert(sb.array_two().second == 1 && sb.back() == "e");
+    sb.push_back_n(strs + 2, 3); // 扩容
+    assert(sb.capacity() == 8 && sb.size() == 6 && sb.front() == "c" && sb.back() == "h");
+    std::string got[6];
+    sb.pop_front_n(got, 6);
+    assert(got[0] == "c" && got[5] == "h" && sb.empty());
+}
+
+// 复制、移动与作为queue的底层容器
+void testCase4(){
+    typedef ring_buffer<std::string> strRing;
+    strRing r1(8);
+    for (int i = 0; i != 20; ++i){
+        r1.push_back(std::string(30, char('a' + i)));
+        if (i % 2) r1.pop_front();
+    }
+    strRing r2(r1);
+    assert(r1 == r2 && r2.capacity() == r1.capacity());
+    r2.push_back(r2.front()); // 引用自身元素，扩容后仍然正确
+    assert(r2.back() == r1.front() && r1 < r2 && r1 != r2);
+    strRing r3(std::move(r2));
+    assert(r2.empty() && r3.size() == r1.size() + 1);
+    r2 = r3;
+    assert(r2 == r3);
+    swap(r1, r3);
+    assert(r1 == r2);
+
+    ring_buffer<std::unique_ptr<int>> up;
+    for (int i = 0; i != 100; ++i) up.push_back(std::unique_ptr<int>(new int(i)));
+    assert(*up.front() == 0 && *up.back() == 99);
+
+    mystl::queue<int, ring_buffer<int>> q;
+    for (int i = 0; i != 1000; ++i){
+        q.push(i);
+        if (i % 2) q.pop();
+    }
+    assert(q.size() == 500 && q.front() == 500 && q.back() == 999);
+    mystl::queue<int, ring_buffer<int>> q2(q);
+    assert(q == q2);
+}
+
+void testAllCases(){
+    testCase1();
+    testCase2();
+    testCase3();
+    testCase4();
+}
+
+} // namespace ring_buffertest
+} // namespace mystl
@@ -0,0 +1,28 @@
+#ifndef MYSTL_RING_BUFFER_TEST_H_
+#define MYSTL_RING_BUFFER_TEST_H_
+
+#include "../queue.h"
+#include "../ring_buffer.h"
+#include "testutil.h"
+
+#include <cassert>
+#include <deque>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace mystl{
+namespace ring_buffertest{
+
+void testCase1();
+void testCase2();
+void testCase3();
+void testCase4();
+
+void testAllCases();
+
+} // namespace ring_buffertest
+} // namespace mystl
+
+#endif
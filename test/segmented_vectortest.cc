@@ -0,0 +1,127 @@
+#include "segmented_vectortest.h"
+
+namespace mystl{
+namespace segmented_vectortest{
+
+// 扩容不搬移元素，先前取得的指针一直有效
+void testCase1(){
+    segmented_vector<int> v;
+    std::vector<int *> addrs;
+    for (int i = 0; i != 100000; ++i){
+        v.push_back(i);
+        addrs.push_back(&v.back());
+    }
+    assert(v.size() == 100000 && v.capacity() >= 100000);
+    for (int i = 0; i != 100000; ++i){
+        assert(addrs[i] == &v[i] && *addrs[i] == i);
+    }
+    assert(v.front() == 0 && v.back() == 99999 && v.at(500) == 500);
+
+    std::vector<int> s;
+    for (auto it = v.begin(); it != v.end(); ++it) s.push_back(*it);
+    assert(mystl::test::container_equal(v, s));
+    assert(v.end() - v.begin() == 100000 && *(v.begin() + 77) == 77);
+    segmented_vector<int>::const_iterator it = v.begin();
+    it += 16;
+    assert(*it == 16 && it[16] == 32);
+}
+
+// 非平凡元素的复制、移动、resize与析构
+void testCase2(){
+    typedef segmented_vector<std::string> strVec;
+    strVec v1(20, std::string(40, 'a'));
+    v1.emplace_back(40, 'b');
+    strVec v2(v1);
+    assert(v1 == v2 && v2.size() == 21 && v2.back() == std::string(40, 'b'));
+    strVec v3(std::move(v1));
+    assert(v3 == v2 && v1.empty());
+    v1 = v3;
+    assert(v1 == v3);
+
+    v2.resize(1000, v2[0]); // value引用自身元素，扩容不会使其失效
+    assert(v2.size() == 1000 && v2[999] == std::string(40, 'a'));
+    v2.resize(5);
+    v2.shrink_to_fit();
+    assert(v2.size() == 5 && v2.capacity() == 16);
+    v2.pop_back();
+    v2.clear();
+    v2.shrink_to_fit();
+    assert(v2.empty() && v2.capacity() == 0);
+
+    segmented_vector<std::unique_ptr<int>> v4;
+    for (int i = 0; i != 100; ++i) v4.push_back(std::unique_ptr<int>(new int(i)));
+    assert(*v4[99] == 99);
+    swap(v4, v4);
+    segmented_vector<std::unique_ptr<int>> v5;
+    swap(v4, v5);
+    assert(v4.empty() && v5.size() == 100 && *v5[50] == 50);
+}
+
+// reserve只配置区块，之后的追加不再配置
+void testCase3(){
+    segmented_vector<int> v{ 1, 2, 3 };
+    v.reserve(1000);
+    size_t cap = v.capacity();
+    assert(cap >= 1000);
+    int *first = &v[0];
+    for (int i = 0; i != 997; ++i) v.push_back(i);
+    assert(v.capacity() == cap && &v[0] == first && v[3] == 0);
+}
+
+// 复制第throw_at次时抛出异常
+struct throwingCopy {
+    static int live;
+    static int copies;
+    static int throw_at;
+    std::string value;
+    throwingCopy() : value(40, 'x') { ++live; }
+    throwingCopy(const throwingCopy& x) : value(x.value) {
+        if (++copies == throw_at) throw std::runtime_error("copy");
+        ++live;
+    }
+    ~throwingCopy() { --live; }
+};
+int throwingCopy::live = 0;
+int throwingCopy::copies = 0;
+int throwingCopy::throw_at = -1;
+
+// 构造中途抛出异常时析构已构造的元素并释放区块
+void testCase4(){
+    throwingCopy value;
+    segmented_vector<throwingCopy> src(100, value);
+    int before = throwingCopy::live;
+    for (int kind = 0; kind != 3; ++kind){
+        throwingCopy::copies = 0;
+        throwingCopy::throw_at = 40;
+        bool thrown = false;
+        try {
+            if (kind == 0) segmented_vector<throwingCopy> v(100, value);
+            else if (kind == 1) segmented_vector<throwingCopy> v(src);
+            else segmented_vector<throwingCopy> v{ value, value };
+        } catch (std::runtime_error&){
+            thrown = true;
+        }
+        assert(kind == 2 ? !thrown : thrown);
+        assert(throwingCopy::live == before);
+    }
+    throwingCopy::copies = 0;
+    throwingCopy::throw_at = 2; // initializer_list复制到第二个元素时抛出
+    bool thrown = false;
+    try {
+        segmented_vector<throwingCopy> v{ value, value, value };
+    } catch (std::runtime_error&){
+        thrown = true;
+    }
+    assert(thrown && throwingCopy::live == before);
+    throwingCopy::throw_at = -1;
+}
+
+void testAllCases(){
+    testCase1();
+    testCase2();
+    testCase3();
+    testCase4();
+}
+
+} // namespace segmented_vectortest
+} // namespace mystl
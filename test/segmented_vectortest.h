@@ -0,0 +1,26 @@
+#ifndef MYSTL_SEGMENTED_VECTOR_TEST_H_
+#define MYSTL_SEGMENTED_VECTOR_TEST_H_
+
+#include "../segmented_vector.h"
+#include "testutil.h"
+
+#include <cassert>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace mystl{
+namespace segmented_vectortest{
+
+void testCase1();
+void testCase2();
+void testCase3();
+void testCase4();
+
+void testAllCases();
+
+} // namespace segmented_vectortest
+} // namespace mystl
+
+#endif
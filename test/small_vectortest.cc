@@ -0,0 +1,148 @@
+#include "small_vectortest.h"
+
+namespace mystl{
+namespace small_vectortest{
+
+// 计数每次分配与释放的memory_resource
+class counting_resource : public memory_resource {
+public:
+    size_t allocs = 0;
+    size_t deallocs = 0;
+protected:
+    virtual void *do_allocate(size_t bytes) {
+        ++allocs;
+        return pool_resource()->allocate(bytes);
+    }
+    virtual void do_deallocate(void *p, size_t bytes) {
+        ++deallocs;
+        pool_resource()->deallocate(p, bytes);
+    }
+};
+
+typedef small_vector<std::string, 4> strVec;
+
+static std::string long_string(int i) { // 超出短字符串优化，析构遗漏时可被检出
+    return std::string(40, 'a' + i % 26);
+}
+
+// 不超过N个元素时不配置内存，超过后才从Alloc配置
+void testCase1(){
+    counting_resource res;
+    {
+        small_vector<int, 8, resource_alloc> v(&res);
+        assert(v.is_inline() && v.capacity() == 8);
+        for (int i = 0; i != 8; ++i) v.push_back(i);
+        assert(res.allocs == 0 && v.is_inline());
+        v.push_back(8);
+        assert(res.allocs == 1 && !v.is_inline() && v.size() == 9);
+        for (int i = 0; i != 9; ++i) assert(v[i] == i);
+        v.erase(v.begin() + 2, v.end());
+        v.shrink_to_fit(); // 元素重新放回内部缓冲区
+        assert(v.is_inline() && v.size() == 2 && v[1] == 1);
+        assert(res.deallocs == 1);
+    }
+    assert(res.allocs == res.deallocs);
+
+    small_vector<int, 4> w{ 1, 2, 3 };
+    assert(w.is_inline() && w.size() == 3 && w[2] == 3);
+    small_vector<int, 4> x(10, 7);
+    assert(!x.is_inline() && x.size() == 10 && x[9] == 7);
+}
+
+// 复制与移动：内部缓冲区中的元素逐个搬移，Alloc区块中的元素直接接管
+void testCase2(){
+    strVec a;
+    for (int i = 0; i != 3; ++i) a.push_back(long_string(i));
+    strVec b(a);
+    assert(b.is_inline() && b.size() == 3 && b[2] == long_string(2));
+    strVec c(std::move(a));
+    assert(c.is_inline() && c.size() == 3 && a.empty());
+
+    strVec d;
+    for (int i = 0; i != 10; ++i) d.push_back(long_string(i));
+    const std::string *data = &d[0];
+    strVec e(std::move(d));
+    assert(&e[0] == data && !e.is_inline() && e.size() == 10); // 接管区块，不搬移元素
+
+    b = e;
+    assert(!b.is_inline() && b.size() == 10 && b[9] == long_string(9));
+    e = std::move(c);
+    assert(e.is_inline() && e.size() == 3 && e[0] == long_string(0));
+}
+
+// swap的三种情形：都在缓冲区、都在Alloc区块、各在一方
+void testCase3(){
+    strVec a, b;
+    a.push_back(long_string(0));
+    for (int i = 1; i != 4; ++i) b.push_back(long_string(i));
+    a.swap(b);
+    assert(a.size() == 3 && b.size() == 1 && a[0] == long_string(1) && b[0] == long_string(0));
+
+    strVec big;
+    for (int i = 0; i != 20; ++i) big.push_back(long_string(i));
+    swap(a, big);
+    assert(!a.is_inline() && a.size() == 20 && a[19] == long_string(19));
+    assert(big.is_inline() && big.size() == 3 && big[2] == long_string(3));
+    big.push_back(long_string(4));
+    big.push_back(long_string(5)); // big的缓冲区仍可使用，满后再配置
+    assert(!big.is_inline() && big.size() == 5);
+
+    a.swap(big);
+    assert(a.size() == 5 && big.size() == 20 && big[0] == long_string(0));
+}
+
+// 只能移动的元素与超过8字节对齐的元素
+struct alignas(32) wide {
+    int value;
+    wide(int v) : value(v) {}
+};
+
+void testCase4(){
+    small_vector<std::unique_ptr<int>, 2> v;
+    for (int i = 0; i != 5; ++i) v.push_back(std::unique_ptr<int>(new int(i)));
+    small_vector<std::unique_ptr<int>, 2> w(std::move(v));
+    assert(w.size() == 5 && *w[4] == 4);
+
+    small_vector<wide, 3> x;
+    for (int i = 0; i != 3; ++i) x.push_back(wide(i));
+    assert(x.is_inline() && reinterpret_cast<size_t>(&x[0]) % 32 == 0);
+    x.push_back(wide(3));
+    assert(!x.is_inline() && reinterpret_cast<size_t>(&x[0]) % 32 == 0 && x[3].value == 3);
+}
+
+// vector的swap、shrink_to_fit与赋值会交换指向内部缓冲区的指针，不能经vector的引用调用
+void testCase5(){
+    static_assert(!std::is_convertible<strVec&, strVec::base_type&>::value,
+                  "small_vector must not bind to a vector reference");
+    static_assert(!std::is_convertible<strVec*, strVec::base_type*>::value,
+                  "small_vector must not bind to a vector pointer");
+
+    strVec a, b;
+    for (int i = 0; i != 3; ++i) a.push_back(long_string(i));
+    for (int i = 0; i != 10; ++i) b.push_back(long_string(i));
+    b.erase(b.begin() + 2, b.end());
+    b.shrink_to_fit(); // small_vector自己的版本，搬回内部缓冲区
+    assert(b.is_inline() && b.size() == 2 && b[1] == long_string(1));
+    a.swap(b);
+    assert(a.is_inline() && b.is_inline() && a.size() == 2 && b.size() == 3);
+    b = a;
+    assert(b == a && b.is_inline() && &b[0] != &a[0]);
+    b.push_back(long_string(5));
+    assert(b != a);
+
+    small_vector<int, 4> v{ 1, 2, 3 };
+    std::ostringstream os;
+    os << v;
+    assert(os.str() == "1 2 3 ");
+}
+
+void testAllCases(){
+    testCase1();
+    testCase2();
+    testCase3();
+    testCase4();
+    testCase5();
+}
+
+} // namespace small_vectortest
+} // namespace mystl
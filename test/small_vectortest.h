@@ -0,0 +1,27 @@
+#ifndef MYSTL_SMALL_VECTOR_TEST_H_
+#define MYSTL_SMALL_VECTOR_TEST_H_
+
+#include "../small_vector.h"
+#include "../memory_resource.h"
+
+#include <cassert>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <type_traits>
+
+namespace mystl{
+namespace small_vectortest{
+
+void testCase1();
+void testCase2();
+void testCase3();
+void testCase4();
+void testCase5();
+
+void testAllCases();
+
+} // namespace small_vectortest
+} // namespace mystl
+
+#endif
@@ -106,7 +106,7 @@ void testCase6(){
 void testCase7(){
     myStr s;
     s.reserve(10);
-    assert(s.capacity() == 10);
+    assert(s.capacity() >= 10); //区块的余量也计入容量
 }
 
 void testCase8(){
@@ -261,6 +261,17 @@ void testCase15(){
     assert(mystl::test::container_equal(s1, s2));
 }
 
+void testCase16(){
+    myStr s("hello");
+    s.resize_default_init(4096); //新增的字符不初始化，随后整体覆盖
+    assert(s.size() == 4096 && s.capacity() >= 4096);
+    assert(s[0] == 'h' && s[4] == 'o');
+    for (size_t i = 5; i != s.size(); ++i) s[i] = 'x';
+    assert(s[4095] == 'x');
+    s.resize_default_init(3);
+    assert(s.size() == 3 && s[2] == 'l');
+}
+
 void testAllCases(){
     testCase1();
     testCase2();
@@ -277,6 +288,7 @@ void testAllCases(){
     testCase13();
     testCase14();
     testCase15();
+    testCase16();
 }
 
 } // namespace stringtest
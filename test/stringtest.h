@@ -30,6 +30,7 @@ void testCase12();
 void testCase13();
 void testCase14();
 void testCase15();
+void testCase16();
 
 void testAllCases();
 
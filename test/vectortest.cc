@@ -247,6 +247,314 @@ void testCase15()
 
 }
 
+//可平凡重定位的元素扩容时经reallocate整体搬移，内容保持不变
+void testCase16(){
+    myVec<int> v1;
+    stdVec<int> v2;
+    for (int i = 0; i != 3000000; ++i) { //超过32K后由realloc扩展
+        v1.push_back(i);
+        v2.push_back(i);
+    }
+    assert(mystl::test::container_equal(v1, v2));
+    v1.push_back(v1[0]); //插入的值引用自身元素
+    assert(v1.back() == 0);
+    v1.reserve(v1.capacity() + 1);
+    assert(v1.size() == 3000001 && v1[2999999] == 2999999);
+
+    myVec<mystl::string> v3;
+    for (int i = 0; i != 1000; ++i) {
+        v3.push_back(mystl::string(static_cast<size_t>(i % 50 + 1),
+                                   static_cast<char>('a' + i % 26)));
+    }
+    v3.insert(v3.end(), 10, mystl::string("tail"));
+    for (int i = 0; i != 1000; ++i) {
+        assert(v3[i].size() == static_cast<size_t>(i % 50 + 1));
+        assert(v3[i][0] == 'a' + i % 26);
+    }
+    assert(v3.size() == 1010 && v3[1009].size() == 4 && v3[1009][0] == 't');
+}
+
+//记录复制与移动次数，Noexcept决定移动构造函数是否声明为noexcept
+template<bool Noexcept>
+struct moveCounter {
+    static int copies;
+    static int moves;
+    int value;
+    moveCounter(int v) : value(v) {}
+    moveCounter(int a, int b) : value(a + b) {}
+    moveCounter(const moveCounter& other) : value(other.value) { ++copies; }
+    moveCounter(moveCounter&& other) noexcept(Noexcept) : value(other.value) {
+        other.value = -1;
+        ++moves;
+    }
+    moveCounter& operator=(const moveCounter& other) {
+        value = other.value;
+        ++copies;
+        return *this;
+    }
+    moveCounter& operator=(moveCounter&& other) noexcept(Noexcept) {
+        value = other.value;
+        other.value = -1;
+        ++moves;
+        return *this;
+    }
+};
+template<bool Noexcept> int moveCounter<Noexcept>::copies = 0;
+template<bool Noexcept> int moveCounter<Noexcept>::moves = 0;
+
+//emplace_back就地构造，扩容时移动构造不抛出异常的元素以移动代替复制
+void testCase17(){
+    typedef moveCounter<true> movable;
+    myVec<movable> v1;
+    for (int i = 0; i != 1000; ++i) v1.emplace_back(i, 1);
+    assert(movable::copies == 0);
+    v1.push_back(movable(1001));
+    v1.insert(v1.begin(), movable(-5));
+    v1.emplace(v1.begin() + 1, 7, 7);
+    assert(movable::copies == 0);
+    assert(v1[0].value == -5 && v1[1].value == 14 && v1[2].value == 1);
+    assert(v1.back().value == 1001 && v1.size() == 1003);
+    v1.push_back(v1[0]); //复制自身元素，扩容时不受搬移影响
+    v1.emplace(v1.begin(), v1.back());
+    assert(v1.front().value == -5 && v1.back().value == -5);
+
+    typedef moveCounter<false> throwing; //移动可能抛出异常时扩容仍然复制
+    myVec<throwing> v2;
+    for (int i = 0; i != 100; ++i) v2.emplace_back(i);
+    assert(throwing::copies > 0);
+    for (int i = 0; i != 100; ++i) assert(v2[i].value == i);
+
+    myVec<std::unique_ptr<int> > v3; //只能移动的元素
+    for (int i = 0; i != 100; ++i) v3.push_back(std::unique_ptr<int>(new int(i)));
+    v3.insert(v3.begin() + 50, std::unique_ptr<int>(new int(-1)));
+    assert(v3.size() == 101 && *v3[50] == -1 && *v3[51] == 50 && *v3[100] == 99);
+
+    stdVec<std::string> v4;
+    myVec<std::string> v5;
+    for (int i = 0; i != 100; ++i) {
+        std::string str(i, 'x');
+        v4.push_back(str);
+        v5.emplace_back(std::move(str));
+    }
+    v4.emplace(v4.begin() + 3, 5, 'y');
+    v5.emplace(v5.begin() + 3, 5, 'y');
+    assert(mystl::test::container_equal(v4, v5));
+}
+
+//只提供allocate/deallocate的配置策略，记录配置次数
+struct counting_alloc {
+    static int allocs;
+    static void *allocate(size_t n) {
+        ++allocs;
+        return alloc::allocate(n);
+    }
+    static void deallocate(void *p, size_t n) { alloc::deallocate(p, n); }
+};
+int counting_alloc::allocs = 0;
+
+//只能单趟遍历的输入迭代器
+struct countingInput : public mystl::iterator<mystl::input_iterator_tag, int> {
+    int value;
+    explicit countingInput(int v) : value(v) {}
+    int operator*() const { return value; }
+    countingInput& operator++() { ++value; return *this; }
+    bool operator!=(const countingInput& x) const { return value != x.value; }
+    bool operator==(const countingInput& x) const { return value == x.value; }
+};
+
+//任意迭代器区间的构造、插入与assign：前向迭代器区间只配置一次
+void testCase18(){
+    int arr[1000];
+    for (int i = 0; i != 1000; ++i) arr[i] = i;
+    mystl::deque<int> dq(arr, arr + 1000);
+    mystl::list<int> lst;
+    for (int i = 0; i != 1000; ++i) lst.push_back(i);
+    stdVec<int> expect(arr, arr + 1000);
+
+    counting_alloc::allocs = 0;
+    mystl::vector<int, counting_alloc> v1(dq.begin(), dq.end());
+    assert(counting_alloc::allocs == 1 && mystl::test::container_equal(v1, expect));
+    mystl::vector<int, counting_alloc> v2(lst.begin(), lst.end());
+    assert(counting_alloc::allocs == 2 && mystl::test::container_equal(v2, expect));
+    mystl::vector<int, counting_alloc> v3(arr, arr + 1000);
+    assert(counting_alloc::allocs == 3 && mystl::test::container_equal(v3, expect));
+
+    v3.insert(v3.begin() + 10, lst.begin(), lst.end()); //容量不足，重新配置一次
+    expect.insert(expect.begin() + 10, arr, arr + 1000);
+    assert(counting_alloc::allocs == 4 && mystl::test::container_equal(v3, expect));
+    v3.reserve(2100);
+    v3.insert(v3.end() - 5, arr, arr + 3); //剩余容量足够，不重新配置
+    expect.insert(expect.end() - 5, arr, arr + 3);
+    assert(counting_alloc::allocs == 5 && mystl::test::container_equal(v3, expect));
+    v3.insert(v3.end() - 2, arr, arr + 10); //插入点之后的元素少于区间长度
+    expect.insert(expect.end() - 2, arr, arr + 10);
+    assert(counting_alloc::allocs == 5 && mystl::test::container_equal(v3, expect));
+
+    v2.assign(dq.begin(), dq.begin() + 10); //保留原有容量
+    assert(counting_alloc::allocs == 5 && v2.size() == 10 && v2[9] == 9);
+    v2.assign(countingInput(5), countingInput(8));
+    assert(v2.size() == 3 && v2[0] == 5 && v2[2] == 7);
+    v2.insert(v2.begin() + 1, countingInput(100), countingInput(102));
+    assert(v2.size() == 5 && v2[1] == 100 && v2[2] == 101 && v2[3] == 6);
+
+    myVec<int> v4(5, 1); //整数参数仍为n个value
+    v4.insert(v4.begin(), 2, 3);
+    v4.assign(3, 9);
+    assert(v4.size() == 3 && v4[2] == 9);
+    myVec<std::string> v5{ "a", "b", "c" };
+    v5.assign({ "x", "y" });
+    assert(v5.size() == 2 && v5[1] == "y");
+}
+
+//有剩余容量时在中间插入n个元素
+void testCase19(){
+    stdVec<std::string> v1;
+    myVec<std::string> v2;
+    v2.reserve(100);
+    for (int i = 0; i != 10; ++i) {
+        v1.push_back(std::string(30, 'a' + i));
+        v2.push_back(std::string(30, 'a' + i));
+    }
+    v1.insert(v1.begin() + 2, 3, "xyz"); //插入点之后的元素多于n个
+    v2.insert(v2.begin() + 2, 3, "xyz");
+    assert(mystl::test::container_equal(v1, v2));
+    v1.insert(v1.end() - 2, 5, "uvw"); //插入点之后的元素少于n个
+    v2.insert(v2.end() - 2, 5, "uvw");
+    assert(mystl::test::container_equal(v1, v2));
+    v1.insert(v1.begin(), 2, v1.back()); //value引用自身元素
+    v2.insert(v2.begin(), 2, v2.back());
+    assert(mystl::test::container_equal(v1, v2));
+    v1.insert(v1.begin() + 1, 200, v1[5]); //容量不足时value同样引用自身元素
+    v2.insert(v2.begin() + 1, 200, v2[5]);
+    assert(mystl::test::container_equal(v1, v2));
+}
+
+//并行初始化：复制第k次时抛出异常，用于检查各块的回滚
+struct throwingCopy {
+    static std::atomic<int> live;
+    static std::atomic<int> copies;
+    static int throw_at;
+    int value;
+    throwingCopy(int v = 0) : value(v) { ++live; }
+    throwingCopy(const throwingCopy& x) : value(x.value) {
+        if (++copies == throw_at) throw std::runtime_error("copy");
+        ++live;
+    }
+    ~throwingCopy() { --live; }
+};
+std::atomic<int> throwingCopy::live(0);
+std::atomic<int> throwingCopy::copies(0);
+int throwingCopy::throw_at = -1;
+
+//开启并行阈值后填充、复制与resize的结果与串行相同，异常时不泄漏
+void testCase20() {
+    mystl::set_parallel_threshold(1);
+    vector<int> v1(100001, 7);
+    assert(v1.size() == 100001 && v1.front() == 7 && v1.back() == 7);
+    for (size_t i = 0; i != v1.size(); ++i) v1[i] = static_cast<int>(i);
+    vector<int> v2(v1);
+    assert(v1 == v2);
+    v2.resize(300000, -1);
+    assert(v2[100000] == 100000 && v2[100001] == -1 && v2.back() == -1);
+    v2.resize(300001, v2[5]); //value引用本vector中的元素
+    assert(v2.back() == 5);
+
+    vector<std::string> v3(1000, std::string(40, 'x'));
+    vector<std::string> v4(v3);
+    v4.resize(5000);
+    assert(v4[999] == v3[0] && v4[1000].empty() && v4.size() == 5000);
+
+    vector<throwingCopy> v5(5000, throwingCopy(3));
+    throwingCopy::copies = 0;
+    throwingCopy::throw_at = 2500;
+    int before = throwingCopy::live;
+    try {
+        vector<throwingCopy> v6(v5);
+        assert(false);
+    } catch (std::runtime_error&) {
+    }
+    assert(throwingCopy::live == before);
+    throwingCopy::throw_at = -1;
+    mystl::set_parallel_threshold(0);
+}
+
+//默认构造时计数，用于检查resize_default_init仍会构造非平凡类型
+struct defaultCounted {
+    static int constructed;
+    int value;
+    defaultCounted() : value(-1) { ++constructed; }
+};
+int defaultCounted::constructed = 0;
+
+//resize_default_init与default_init构造只做默认初始化
+void testCase21() {
+    vector<int> v1{ 1, 2, 3 };
+    v1.resize_default_init(100000);
+    assert(v1.size() == 100000 && v1[2] == 3 && v1.capacity() >= 100000);
+    for (size_t i = 3; i != v1.size(); ++i) v1[i] = static_cast<int>(i);
+    assert(v1.back() == 99999);
+    v1.resize_default_init(2);
+    assert(v1.size() == 2 && v1[1] == 2);
+
+    vector<unsigned char> v2(1 << 20, mystl::default_init);
+    assert(v2.size() == (1 << 20) && v2.capacity() == v2.size());
+
+    vector<defaultCounted> v3(10, mystl::default_init);
+    assert(defaultCounted::constructed == 10 && v3[9].value == -1);
+    v3.resize_default_init(25);
+    assert(defaultCounted::constructed == 25 && v3[24].value == -1);
+
+    vector<std::string> v4(3, std::string(40, 'a'));
+    v4.resize_default_init(50);
+    assert(v4[2] == std::string(40, 'a') && v4[49].empty());
+}
+
+//构造函数可能抛出异常，析构时释放持有的内存
+struct throwingCtor {
+    static int ctors;
+    static int dtors;
+    int *value;
+    throwingCtor(int v, bool fail) : value(0) {
+        if (fail) throw std::runtime_error("ctor");
+        value = new int(v);
+        ++ctors;
+    }
+    throwingCtor(const throwingCtor& x) : value(new int(*x.value)) { ++ctors; }
+    throwingCtor& operator=(const throwingCtor& x) {
+        *value = *x.value;
+        return *this;
+    }
+    ~throwingCtor() {
+        delete value;
+        ++dtors;
+    }
+};
+int throwingCtor::ctors = 0;
+int throwingCtor::dtors = 0;
+
+//扩容时新元素的构造抛出异常，不析构未构造的元素，原有元素不变
+void testCase22() {
+    {
+        vector<throwingCtor> v;
+        for (int i = 0; i != 4; ++i) v.emplace_back(i, false);
+        while (v.size() != v.capacity()) v.emplace_back(int(v.size()), false);
+        size_t n = v.size();
+        try {
+            v.emplace_back(-1, true);
+            assert(false);
+        } catch (std::runtime_error&) {
+        }
+        try {
+            v.emplace(v.begin() + 1, -1, true);
+            assert(false);
+        } catch (std::runtime_error&) {
+        }
+        assert(v.size() == n && *v[0].value == 0 && *v[n - 1].value == int(n - 1));
+        assert(throwingCtor::ctors - throwingCtor::dtors == int(n));
+    }
+    assert(throwingCtor::ctors == throwingCtor::dtors);
+}
+
 void testAllCases() {
     testCase1();
     testCase2();
@@ -263,6 +571,13 @@ void testAllCases() {
     testCase13();
     testCase14();
 //    testCase15();
+    testCase16();
+    testCase17();
+    testCase18();
+    testCase19();
+    testCase20();
+    testCase21();
+    testCase22();
 }
 
 
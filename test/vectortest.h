@@ -1,15 +1,21 @@
 #ifndef MYSTL_VECTOR_TEST_H_
 #define MYSTL_VECTOR_TEST_H_
 
+#include "../deque.h"
+#include "../list.h"
+#include "../string.h"
 #include "../vector.h"
 #include "testutil.h"
 
 #include <vector>
 
 #include <array>
+#include <atomic>
 #include <cassert>
 #include <iostream>
 #include <iterator>
+#include <memory>
+#include <stdexcept>
 #include <string>
 
 namespace mystl{
@@ -34,6 +40,14 @@ namespace vectortest{
     void testCase12();
     void testCase13();
     void testCase14();
+    void testCase15();
+    void testCase16();
+    void testCase17();
+    void testCase18();
+    void testCase19();
+    void testCase20();
+    void testCase21();
+    void testCase22();
 
     void testAllCases();
 
@@ -1,6 +1,8 @@
 #ifndef MYSTL_TYPE_TRAITS_H_
 #define MYSTL_TYPE_TRAITS_H_
 
+#include <type_traits> //for conditional, is_trivially_copyable
+
 namespace mystl {
 
 struct _true_type {  };
@@ -233,6 +235,15 @@ struct _type_traits<const signed char*> {
     typedef _true_type    is_POD_type;
 };
 
+//可平凡重定位：把对象的字节搬到新地址并不再析构原对象，等价于复制后析构原对象
+//平凡可复制的类型都满足；不保存指向自身地址的类型（如string）可特化为_true_type，
+//vector扩容时对这类元素经配置器的reallocate整体搬移缓冲区，不逐个复制
+template<typename T>
+struct _relocate_traits {
+    typedef typename std::conditional<std::is_trivially_copyable<T>::value,
+        _true_type, _false_type>::type is_trivially_relocatable;
+};
+
 } //namespace mystl
 
 #endif
@@ -40,6 +40,7 @@ public:
     typedef typename ht::value_type         value_type;
     typedef typename ht::hasher             hasher;
     typedef typename ht::key_equal          key_equal;
+    typedef typename ht::allocator_type     allocator_type;
 
     typedef typename ht::size_type          size_type;
     typedef typename ht::difference_type    difference_type;
@@ -56,6 +57,9 @@ public:
     unordered_map(size_type n, const hasher& hf) : rep(n, hf, key_equal()) {}
     unordered_map(size_type n, const hasher& hf, const key_equal& eql)
         : rep(n, hf, eql) {}
+    unordered_map(size_type n, const hasher& hf, const key_equal& eql,
+                  const allocator_type& a)
+        : rep(n, hf, eql, a) {}
 
     template <typename InputIterator>
     unordered_map(InputIterator f, InputIterator l)
@@ -75,6 +79,7 @@ public:
     // 返回hash相关函数
     hasher hash_funct() const { return rep.hash_funct(); }
     key_equal key_eq() const { return rep.key_eq(); }
+    allocator_type get_allocator() const { return rep.get_allocator(); }
 
 public:
     size_type size() const { return rep.size(); }
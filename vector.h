@@ -5,6 +5,7 @@
 #include "construct.h"
 #include "typetraits.h"
 #include "iterator.h"
+#include "parallel.h"
 
 #include <iterator> //for std::iterator
 #include <algorithm> //for fill_n, max
@@ -12,13 +13,16 @@
 #include <cstddef> //for ptrdiff_t
 #include <initializer_list> //for initializer_list
 #include <iostream> //for ostream
-#include <utility> //for forward, swap
+#include <utility> //for forward, move, swap
+#include <type_traits> //for conditional, is_nothrow_move_constructible
 #include <stdexcept> //for out_of_range
 
 namespace mystl {
 
+//vector以protected方式继承其空间配置器，无状态的Alloc不增加vector的大小
+//派生的small_vector经此访问其配置策略中的内嵌缓冲区
 template<typename T, typename Alloc = alloc>
-class vector {
+class vector : protected allocator<T, Alloc> {
 
 public:
     //vector的嵌套类型定义
@@ -31,6 +35,7 @@ public:
     typedef const value_type&   const_reference;
     typedef size_t              size_type;
     typedef ptrdiff_t           difference_type;
+    typedef Alloc               allocator_type;
 
 protected:
     typedef allocator<T, Alloc> data_allocator; //空间配置器
@@ -39,11 +44,33 @@ protected:
     iterator finish_; //表示目前使用空间的尾（后）
     iterator end_of_storage_; // 表示目前可用空间的尾（后）
 
-    void insert_aux(iterator position, const value_type& x);
+    //在position处以args构造一个元素，args可以引用本vector中的元素
+    template<typename... Args>
+    void emplace_aux(iterator position, Args&&... args);
+    //内存不足时扩容为原来的2倍，在新区块的对应位置构造元素后搬移原有元素
+    template<typename... Args>
+    void realloc_insert(iterator position, Args&&... args);
+    //内存不足时在尾部插入，可平凡重定位的元素经reallocate_storage整体搬移
+    template<typename... Args>
+    void realloc_append(_true_type, Args&&... args);
+    template<typename... Args>
+    void realloc_append(_false_type, Args&&... args);
     void insert_aux(iterator position, const size_type& n, const value_type& x);
+    //将[first, last)搬移到未初始化的result处：移动构造不抛出异常（或元素不可复制）时移动，
+    //否则复制，扩容中途抛出异常时原有元素保持不变
+    static iterator relocate(iterator first, iterator last, iterator result);
+
+    typedef typename _relocate_traits<T>::is_trivially_relocatable trivially_relocatable;
+    //将缓冲区重新配置为可容纳n个元素并保留原有元素
+    void reallocate_storage(size_type n) { reallocate_storage(n, trivially_relocatable()); }
+    //可平凡重定位的元素经配置器的reallocate整体搬移，大缓冲区可不经复制地扩展
+    void reallocate_storage(size_type n, _true_type);
+    //其余元素复制到新区块后析构原有元素
+    void reallocate_storage(size_type n, _false_type);
 
     void deallocate();
 
+    //元素总字节数达到并行阈值时，填充与复制分块交给线程池，见parallel.h
     iterator allocate_and_fill(const size_type n, const value_type& value);
 
     iterator allocate_and_copy(iterator first, iterator last);
@@ -51,14 +78,66 @@ protected:
 
     void fill_initialize(size_type n, const value_type& value);
 
+    //区间构造与插入按参数是否为整数、迭代器的类型分派
+    template<typename Integer>
+    void range_initialize(Integer n, Integer value, std::true_type) {
+        fill_initialize(n, value);
+    }
+    template<typename InputIterator>
+    void range_initialize(InputIterator first, InputIterator last, std::false_type) {
+        insert(end(), first, last);
+    }
+    template<typename Integer>
+    void insert_dispatch(iterator position, Integer n, Integer value, std::true_type) {
+        if (n > 0) insert_aux(position, static_cast<size_type>(n), value);
+    }
+    template<typename InputIterator>
+    void insert_dispatch(iterator position, InputIterator first, InputIterator last,
+                         std::false_type) {
+        range_insert(position, first, last, iterator_category(first));
+    }
+    //输入迭代器只能逐个插入
+    template<typename InputIterator>
+    void range_insert(iterator position, InputIterator first, InputIterator last,
+                      input_iterator_tag);
+    template<typename ForwardIterator>
+    void range_insert(iterator position, ForwardIterator first, ForwardIterator last,
+                      forward_iterator_tag);
+    template<typename ForwardIterator>
+    static size_type range_distance(ForwardIterator first, ForwardIterator last,
+                                    forward_iterator_tag) {
+        size_type n = 0;
+        for ( ; first != last; ++first) ++n;
+        return n;
+    }
+    template<typename RandomAccessIterator>
+    static size_type range_distance(RandomAccessIterator first, RandomAccessIterator last,
+                                    random_access_iterator_tag) {
+        return static_cast<size_type>(last - first);
+    }
+    //将[first, last)移动到未初始化的result处，元素已在本vector内部，不需要保证原有元素不变
+    static iterator uninitialized_move(iterator first, iterator last, iterator result) {
+        return std::uninitialized_copy(std::make_move_iterator(first),
+                                       std::make_move_iterator(last), result);
+    }
+
 public:
     //构造，析构，复制，移动相关函数
     vector() : start_(0), finish_(0), end_of_storage_(0) {}
+    explicit vector(const allocator_type& a)
+        : data_allocator(a), start_(0), finish_(0), end_of_storage_(0) {}
     vector(size_type n, const T& value) { fill_initialize(n, value); }
+    vector(size_type n, const T& value, const allocator_type& a)
+        : data_allocator(a) { fill_initialize(n, value); }
     vector(int n, const value_type& value) { fill_initialize(n, value); }
     vector(long n, const value_type& value) { fill_initialize(n, value); }
     explicit vector(size_type n) { fill_initialize(n, T()); } //防止出现vector<T> vec = n
-    vector(iterator first, iterator last);
+    vector(size_type n, default_init_t); //n个默认初始化的元素，平凡类型不写入
+    //InputIterator为整数类型时等同于vector(n, value)
+    template<typename InputIterator>
+    vector(InputIterator first, InputIterator last) : start_(0), finish_(0), end_of_storage_(0) {
+        range_initialize(first, last, typename std::is_integral<InputIterator>::type());
+    }
     vector(std::initializer_list<value_type> values) //列表初始化
         :vector(values.begin(), values.end()) {}
     vector(const vector& vec);
@@ -71,6 +150,8 @@ public:
         deallocate(); //成员函数
     }
 
+    allocator_type get_allocator() const { return data_allocator::policy(); }
+
     //比较相关操作
     bool operator==(const vector& vec) const;
     bool operator!=(const vector& vec) const;
@@ -87,7 +168,10 @@ public:
         return static_cast<size_type>(end_of_storage_ - cbegin());
     }
     bool empty() const { return begin() == end(); }
-    void resize(size_type n);
+    void resize(size_type n) { resize(n, T()); }
+    void resize(size_type n, const value_type& value); //新增的元素达到并行阈值时并行构造
+    //新增的元素只做默认初始化，平凡类型的元素不写入，供随后整体覆盖的缓冲区使用
+    void resize_default_init(size_type n);
     void reserve(size_type n);
     void shrink_to_fit(); //调整容器容量大小为size
 
@@ -105,21 +189,28 @@ public:
     //操作容器相关
     void clear();
     void swap(vector& vec);
-    void push_back(const value_type& value);
+    void push_back(const value_type& value) { emplace_back(value); }
+    void push_back(value_type&& value) { emplace_back(std::move(value)); }
     template<typename... Args>
     void emplace_back(Args&&... args);
     void pop_back();
     template<typename... Args>
     iterator emplace(iterator position, Args&&... args);
     iterator insert(iterator position, const value_type& value);
+    iterator insert(iterator position, value_type&& value) {
+        return emplace(position, std::move(value));
+    }
     iterator insert(iterator position, const size_type& n, const value_type& value);
-    iterator insert(iterator position, iterator first, iterator last);
+    //前向迭代器区间先求出长度，最多只重新配置一次
+    template<typename InputIterator>
+    iterator insert(iterator position, InputIterator first, InputIterator last);
     iterator insert(iterator position, std::initializer_list<value_type> lst);
     iterator erase(iterator position);
     iterator erase(iterator first, iterator last);
-    void assign(iterator first, iterator last);
+    template<typename InputIterator>
+    void assign(InputIterator first, InputIterator last);
     void assign(std::initializer_list<value_type> lst);
-    void assign(size_type n, value_type& value);
+    void assign(size_type n, const value_type& value);
 
 public:
     //重载输出运算符
@@ -152,7 +243,12 @@ template<typename T, typename Alloc>
 typename vector<T, Alloc>::iterator
 vector<T, Alloc>::allocate_and_fill(const size_type n, const value_type& value) {
     iterator result = data_allocator::allocate(n);
-    std::uninitialized_fill_n(result, n, value);
+    try {
+        parallel_uninitialized_fill_n(result, n, value);
+    } catch(...) {
+        data_allocator::deallocate(result, n);
+        throw;
+    }
     return result;
 }
 
@@ -160,7 +256,12 @@ template<typename T, typename Alloc>
 typename vector<T, Alloc>::iterator
 vector<T, Alloc>::allocate_and_copy(iterator first, iterator last) {
     iterator result = data_allocator::allocate(last - first);
-    std::uninitialized_copy(first, last, result);
+    try {
+        parallel_uninitialized_copy<T>(first, last, result);
+    } catch(...) {
+        data_allocator::deallocate(result, last - first);
+        throw;
+    }
     return result;
 }
  //重载allocate_and_copy
@@ -168,21 +269,29 @@ template<typename T, typename Alloc>
 typename vector<T, Alloc>::iterator
 vector<T, Alloc>::allocate_and_copy(const_iterator first, const_iterator last) {
     iterator result = data_allocator::allocate(last - first);
-    std::uninitialized_copy(first, last, result);
+    try {
+        parallel_uninitialized_copy<T>(first, last, result);
+    } catch(...) {
+        data_allocator::deallocate(result, last - first);
+        throw;
+    }
     return result;
 }
 
 template<typename T, typename Alloc>
-vector<T, Alloc>::vector(iterator first, iterator last) {
-    if (first == last) return;
-    auto n = last - first;
-    start_ = allocate_and_copy(first, last);
-    finish_ = start_ + n;
+vector<T, Alloc>::vector(size_type n, default_init_t) {
+    start_ = data_allocator::allocate(n);
+    try {
+        finish_ = uninitialized_default_n(start_, n);
+    } catch(...) {
+        data_allocator::deallocate(start_, n);
+        throw;
+    }
     end_of_storage_ = finish_;
 }
 
-template<typename T, typename Alloc> //拷贝构造函数
-vector<T, Alloc>::vector(const vector& vec) {
+template<typename T, typename Alloc> //拷贝构造函数，沿用vec的配置器
+vector<T, Alloc>::vector(const vector& vec) : data_allocator(vec) {
     start_ = allocate_and_copy(vec.begin(), vec.end());
     finish_ = start_ + std::distance(vec.begin(), vec.end());
     end_of_storage_ = finish_;
@@ -190,7 +299,7 @@ vector<T, Alloc>::vector(const vector& vec) {
 }
 
 template<typename T, typename Alloc> //移动构造函数
-vector<T, Alloc>::vector(vector&& vec) {
+vector<T, Alloc>::vector(vector&& vec) : data_allocator(vec) {
     //start_ = vec.begin();
     //finish_ = vec.end();
     //end_of_storage_ = start_ + vec.capacity();
@@ -223,7 +332,7 @@ vector<T, Alloc>& vector<T, Alloc>::operator=(vector&& vec) noexcept {
 
 template<typename T, typename Alloc>
 vector<T, Alloc>& vector<T, Alloc>::operator=(vector vec) {
-    swap(*this, vec);
+    swap(vec);
     return *this;
 }
 
@@ -251,25 +360,56 @@ bool vector<T, Alloc>::operator!=(const vector& vec) const {
 
 //**********迭代器和容量相关**********
 template<typename T, typename Alloc>
-void vector<T, Alloc>::resize(size_type n) {
-    if (n < size()) {
+void vector<T, Alloc>::resize(size_type n, const value_type& value) {
+    if (n <= size()) {
         erase(begin() + n, end());
-    } else {
-        insert(end(), n - size(), T());
+        return;
+    }
+    value_type val_copy = value; //value可能引用本vector中的元素
+    if (n > capacity()) reallocate_storage(size() + std::max(size(), n - size()));
+    finish_ = parallel_uninitialized_fill_n(finish_, n - size(), val_copy);
+}
+
+template<typename T, typename Alloc>
+void vector<T, Alloc>::resize_default_init(size_type n) {
+    if (n <= size()) {
+        erase(begin() + n, end());
+        return;
     }
+    if (n > capacity()) reallocate_storage(size() + std::max(size(), n - size()));
+    finish_ = uninitialized_default_n(finish_, n - size());
 }
 
 template<typename T, typename Alloc>
 void vector<T, Alloc>::reserve(size_type n) {
-    if (capacity() < n) {
-        const size_type old_size = size();
-        iterator tmp = allocate_and_copy(start_, finish_);
-        destroy(start_, finish_);
-        deallocate();
-        start_ = tmp;
-        finish_ = tmp + old_size;
-        end_of_storage_ = start_ + n;
+    if (capacity() < n)
+        reallocate_storage(n);
+}
+
+template<typename T, typename Alloc>
+void vector<T, Alloc>::reallocate_storage(size_type n, _true_type) {
+    const size_type old_size = size();
+    start_ = data_allocator::reallocate(start_, capacity(), n);
+    finish_ = start_ + old_size;
+    end_of_storage_ = start_ + n;
+}
+
+template<typename T, typename Alloc>
+void vector<T, Alloc>::reallocate_storage(size_type n, _false_type) {
+    size_type len;
+    iterator tmp = data_allocator::allocate_at_least(n, len); //区块的余量也计入容量
+    iterator new_finish;
+    try {
+        new_finish = relocate(start_, finish_, tmp);
+    } catch(...) {
+        data_allocator::deallocate(tmp, len);
+        throw;
     }
+    destroy(start_, finish_);
+    deallocate();
+    start_ = tmp;
+    finish_ = new_finish;
+    end_of_storage_ = start_ + len;
 }
 
 template<typename T, typename Alloc>
@@ -292,6 +432,7 @@ void vector<T, Alloc>::swap(vector& vec) {
     swap(start_, vec.start_);
     swap(finish_, vec.finish_);
     swap(end_of_storage_, vec.end_of_storage_);
+    swap(static_cast<data_allocator&>(*this), static_cast<data_allocator&>(vec)); //配置器随内存交换
 }
 
 template<typename T, typename Alloc>
@@ -300,35 +441,113 @@ void vector<T, Alloc>::clear() {
 }
 
 template<typename T, typename Alloc>
-void vector<T, Alloc>::push_back(const value_type& value) {
-    if (finish_ != end_of_storage_) {
-        construct(finish_, value);
+typename vector<T, Alloc>::iterator
+vector<T, Alloc>::relocate(iterator first, iterator last, iterator result) {
+    typedef typename std::conditional<!std::is_nothrow_move_constructible<T>::value
+        && std::is_copy_constructible<T>::value, const T*, std::move_iterator<T*> >::type source;
+    return std::uninitialized_copy(source(first), source(last), result);
+}
+
+template<typename T, typename Alloc>
+template<typename... Args>
+void vector<T, Alloc>::emplace_aux(iterator position, Args&&... args) {
+    if (finish_ != end_of_storage_ && position == finish_) { //在尾部插入，直接构造
+        construct(finish_, std::forward<Args>(args)...);
         ++finish_;
-    } else {
-        insert_aux(end(), value);
+    } else if (finish_ != end_of_storage_) { //还有剩余内存
+        value_type val_copy(std::forward<Args>(args)...); //args可能引用将被移动的元素，先构造
+        construct(finish_, std::move(*(finish_ - 1)));
+        ++finish_;
+        std::move_backward(position, finish_ - 2, finish_ - 1);
+        *position = std::move(val_copy);
+    } else if (position == finish_) { //内存不足且在尾部插入
+        realloc_append(trivially_relocatable(), std::forward<Args>(args)...);
+    } else { //内存不足，重新分配（原来的2倍）
+        realloc_insert(position, std::forward<Args>(args)...);
     }
 }
 
 template<typename T, typename Alloc>
-void vector<T, Alloc>::insert_aux(iterator position, const value_type& value) {
-    if (finish_ != end_of_storage_) { //还有剩余内存
-        construct(finish_, *(finish_ -1));
-        ++finish_;
+template<typename... Args>
+void vector<T, Alloc>::realloc_append(_true_type, Args&&... args) {
+    value_type val_copy(std::forward<Args>(args)...); //args可能引用本vector中的元素，扩容前先构造
+    reallocate_storage(size() != 0 ? 2 * size() : 1);
+    construct(finish_, std::move(val_copy));
+    ++finish_;
+}
+
+template<typename T, typename Alloc>
+template<typename... Args>
+void vector<T, Alloc>::realloc_append(_false_type, Args&&... args) {
+    realloc_insert(finish_, std::forward<Args>(args)...);
+}
+
+template<typename T, typename Alloc>
+template<typename... Args>
+void vector<T, Alloc>::realloc_insert(iterator position, Args&&... args) {
+    const size_type old_size = size();
+    size_type len = old_size != 0 ? 2 * old_size : 1;
+    iterator new_start = data_allocator::allocate_at_least(len, len); //len更新为区块实际可容纳的个数
+    iterator new_position = new_start + (position - start_);
+    iterator filled = new_position;
+    iterator new_finish = 0;
+    try {
+        //先构造新元素，此时args引用的原有元素尚未被移动
+        construct(new_position, std::forward<Args>(args)...);
+        filled = new_position + 1;
+        new_finish = relocate(start_, position, new_start);
+        ++new_finish;
+        new_finish = relocate(position, finish_, new_finish);
+    } catch(...) {
+        if (new_finish == 0) destroy(new_position, filled);
+        else destroy(new_start, new_finish);
+        data_allocator::deallocate(new_start, len);
+        throw;
+    }
+    destroy(begin(), end());
+    deallocate();
+    start_ = new_start;
+    finish_ = new_finish;
+    end_of_storage_ = new_start + len;
+}
+
+//重载insert_aux
+template<typename T, typename Alloc>
+void vector<T, Alloc>::insert_aux(iterator position, const size_type& n, const value_type& value) {
+    if (size_type(end_of_storage_ - finish_) >= n) { //还有剩余内存
+        value_type val_copy = value; //value可能引用将被移动的元素
+        const size_type elems_after = finish_ - position;
+        iterator old_finish = finish_;
+        if (elems_after > n) { //插入点之后的元素多于n个，末尾n个移入未初始化的空间
+            uninitialized_move(finish_ - n, finish_, finish_);
+            finish_ += n;
+            std::move_backward(position, old_finish - n, old_finish);
+            std::fill(position, position + n, val_copy);
+        } else {
+            finish_ = std::uninitialized_fill_n(finish_, n - elems_after, val_copy);
+            finish_ = uninitialized_move(position, old_finish, finish_);
+            std::fill(position, old_finish, val_copy);
+        }
+    } else if (position == finish_) { //内存不足且在尾部插入，扩容后直接构造
         value_type val_copy = value;
-        std::copy_backward(position, finish_ - 2, finish_ -1);
-        *position = val_copy;
-    } else { //内存不足，重新分配（原来的2倍）
+        reallocate_storage(size() + std::max(size(), n));
+        finish_ = std::uninitialized_fill_n(finish_, n, val_copy);
+    } else { //内存不足，重新分配（原来的加上max(old_size, n)）
         const size_type old_size = size();
-        const size_type len = old_size != 0 ? 2 * old_size : 1;
-        iterator new_start = data_allocator::allocate(len);
-        iterator new_finish = new_start;
+        size_type len = old_size + std::max(old_size, n);
+        iterator new_start = data_allocator::allocate_at_least(len, len);
+        iterator new_position = new_start + (position - start_);
+        iterator filled = new_position;
+        iterator new_finish = 0;
         try {
-            new_finish = std::uninitialized_copy(start_, position, new_start);
-            construct(new_finish, value);
-            ++new_finish;
-            new_finish = std::uninitialized_copy(position, finish_, new_finish);
+            //先构造新元素，此时value引用的原有元素尚未被移动
+            filled = std::uninitialized_fill_n(new_position, n, value);
+            new_finish = relocate(start_, position, new_start);
+            new_finish += n;
+            new_finish = relocate(position, finish_, new_finish);
         } catch(...) {
-            destroy(new_start, new_finish);
+            if (new_finish == 0) destroy(new_position, filled);
+            else destroy(new_start, new_finish);
             data_allocator::deallocate(new_start, len);
             throw;
         }
@@ -340,30 +559,47 @@ void vector<T, Alloc>::insert_aux(iterator position, const value_type& value) {
     }
 }
 
-//重载insert_aux
 template<typename T, typename Alloc>
-void vector<T, Alloc>::insert_aux(iterator position, const size_type& n, const value_type& value) {
-    if ((finish_  + n) <= end_of_storage_) { //还有剩余内存
-        construct(finish_, *(finish_ -n));
-        finish_ += n;
-        value_type val_copy = value;
-        std::copy_backward(position, finish_ - 2, finish_ -1);
-        for (auto i = 0; i != n; ++i) {
-            *position = val_copy;
-            ++position;
+template<typename InputIterator>
+void vector<T, Alloc>::range_insert(iterator position, InputIterator first, InputIterator last,
+                                    input_iterator_tag) {
+    for ( ; first != last; ++first) {
+        position = insert(position, *first);
+        ++position;
+    }
+}
+
+//区间不能来自本vector；平凡可复制的元素从指针区间复制时，uninitialized_copy与copy即为memmove
+template<typename T, typename Alloc>
+template<typename ForwardIterator>
+void vector<T, Alloc>::range_insert(iterator position, ForwardIterator first,
+                                    ForwardIterator last, forward_iterator_tag) {
+    const size_type n = range_distance(first, last, iterator_category(first));
+    if (n == 0) return;
+    if (size_type(end_of_storage_ - finish_) >= n) { //还有剩余内存
+        const size_type elems_after = finish_ - position;
+        iterator old_finish = finish_;
+        if (elems_after > n) {
+            uninitialized_move(finish_ - n, finish_, finish_);
+            finish_ += n;
+            std::move_backward(position, old_finish - n, old_finish);
+            std::copy(first, last, position);
+        } else {
+            ForwardIterator mid = first;
+            for (size_type i = 0; i != elems_after; ++i) ++mid;
+            finish_ = std::uninitialized_copy(mid, last, finish_);
+            finish_ = uninitialized_move(position, old_finish, finish_);
+            std::copy(first, mid, position);
         }
-    } else { //内存不足，重新分配（原来的加上max(old_size, n)）
+    } else { //内存不足，一次配置足够的空间
         const size_type old_size = size();
-        const size_type len = old_size + max(old_size, n);
-        iterator new_start = data_allocator::allocate(len);
+        size_type len = old_size + std::max(old_size, n);
+        iterator new_start = data_allocator::allocate_at_least(len, len);
         iterator new_finish = new_start;
         try {
-            new_finish = std::uninitialized_copy(start_, position, new_start);
-            for (auto i = 0; i < n; ++i) {
-                construct(new_finish, value);
-                ++new_finish;
-            }
-            new_finish = std::uninitialized_copy(position, finish_, new_finish);
+            new_finish = relocate(start_, position, new_start);
+            new_finish = std::uninitialized_copy(first, last, new_finish);
+            new_finish = relocate(position, finish_, new_finish);
         } catch(...) {
             destroy(new_start, new_finish);
             data_allocator::deallocate(new_start, len);
@@ -385,8 +621,13 @@ void vector<T, Alloc>::pop_back() {
 
 template<typename T, typename Alloc>
 template<typename... Args>
-void vector<T, Alloc>::emplace_back(Args&&... args) { //先构造value_type,然后调用push_back
-    push_back(value_type(std::forward<Args>(args)...)); //c++11 forward转发
+void vector<T, Alloc>::emplace_back(Args&&... args) { //在尾部就地构造，c++11 forward转发
+    if (finish_ != end_of_storage_) {
+        construct(finish_, std::forward<Args>(args)...);
+        ++finish_;
+    } else {
+        realloc_append(trivially_relocatable(), std::forward<Args>(args)...);
+    }
 }
 
 template<typename T, typename Alloc>
@@ -396,36 +637,34 @@ vector<T, Alloc>::emplace(iterator position, Args&&... args) {
     if (position < cbegin() || position > cend()) {
         throw std::out_of_range("vector::emplace() - parameter \"position\" is out of bound");
     }
-    auto n = position - cbegin();
-    insert(position, value_type(std::forward<Args>(args)...));
-    return cbegin() + n;
+    auto n = position - begin();
+    emplace_aux(position, std::forward<Args>(args)...);
+    return begin() + n;
 }
 
 template<typename T, typename Alloc>
 typename vector<T, Alloc>::iterator
 vector<T, Alloc>::insert(iterator position, const value_type& value) {
     auto n = position -begin();
-    insert_aux(position, value);
+    emplace_aux(position, value);
     return begin() + n;
 }
 
 template<typename T, typename Alloc>
 typename vector<T, Alloc>::iterator
 vector<T, Alloc>::insert(iterator position, const size_type& n, const value_type& value) {
-    if (n == 0) return 0;
+    if (n == 0) return position;
     auto tmp = position - begin();
     insert_aux(position, n, value);
     return begin() + tmp;
 }
 
 template<typename T, typename Alloc>
+template<typename InputIterator>
 typename vector<T, Alloc>::iterator
-vector<T, Alloc>::insert(iterator position, iterator first, iterator last) {
-    if (first == last) return 0;
+vector<T, Alloc>::insert(iterator position, InputIterator first, InputIterator last) {
     auto n = position - begin();
-    for (auto iter = first; iter != last; ++iter) {
-        insert(position, *iter);
-    }
+    insert_dispatch(position, first, last, typename std::is_integral<InputIterator>::type());
     return begin() + n;
 }
 
@@ -439,7 +678,7 @@ template<typename T, typename Alloc>
 typename vector<T, Alloc>::iterator
 vector<T, Alloc>::erase(iterator position) {
     if (position + 1 != cend()) {
-        std::copy(position + 1, finish_, position);
+        std::move(position + 1, finish_, position);
     }
     --finish_;
     destroy(finish_);
@@ -449,16 +688,18 @@ vector<T, Alloc>::erase(iterator position) {
 template<typename T, typename Alloc>
 typename vector<T, Alloc>::iterator
 vector<T, Alloc>::erase(iterator first, iterator last) {
-    auto i = std::copy(last, finish_, first);
+    auto i = std::move(last, finish_, first);
     destroy(i, finish_);
     finish_ = finish_ - (last - first);
     return first;
 }
 
+//保留原有容量，区间长度超过容量时只重新配置一次
 template<typename T, typename Alloc>
-void vector<T, Alloc>::assign(iterator first, iterator last) {
+template<typename InputIterator>
+void vector<T, Alloc>::assign(InputIterator first, InputIterator last) {
     clear();
-    insert(start_, first, last);
+    insert(end(), first, last);
 }
 
 template<typename T, typename Alloc>
@@ -467,11 +708,14 @@ void vector<T, Alloc>::assign(std::initializer_list<value_type> lst) {
 }
 
 template<typename T, typename Alloc>
-void vector<T, Alloc>::assign(size_type n, value_type& value) {
+void vector<T, Alloc>::assign(size_type n, const value_type& value) {
+    value_type val_copy = value; //value可能引用本vector中的元素
     clear();
-    insert(start_, n, value);
+    insert(end(), n, val_copy);
 }
 
 } //namespace mystl
 
+#include "bvector.h" //vector<bool>的特化版本
+
 #endif